@@ -11,6 +11,7 @@ if __name__ == "__main__":
 
     run_command(["cmake", "--build", ".", "--target", "Luau.Analysis", "--config", "Release"])
     run_command(["cmake", "--build", ".", "--target", "Luau.Ast", "--config", "Release"])
+    run_command(["cmake", "--build", ".", "--target", "Luau.CodeGen", "--config", "Release"])
     run_command(["cmake", "--build", ".", "--target", "Luau.Compiler", "--config", "Release"])
     run_command(["cmake", "--build", ".", "--target", "Luau.Config", "--config", "Release"])
     run_command(["cmake", "--build", ".", "--target", "Luau.VM", "--config", "Release"])
@@ -18,6 +19,7 @@ if __name__ == "__main__":
     # TODO: for windows build, we'd need to do something different here
     run_command(["ar", "-x", "./libLuau.Analysis.a"])
     run_command(["ar", "-x", "./libLuau.Ast.a"])
+    run_command(["ar", "-x", "./libLuau.CodeGen.a"])
     run_command(["ar", "-x", "./libLuau.Compiler.a"])
     run_command(["ar", "-x", "./libLuau.Config.a"])
     run_command(["ar", "-x", "./libLuau.VM.a"])
@@ -3,6 +3,8 @@
 #include "raylib.h"
 #include <string_view>
 
+#include "fontloader.hpp"
+
 namespace frostbyte {
 
 extern Shader round_shader;
@@ -69,7 +71,7 @@ inline void drawingDrawText(Vector2* position, Font* font, float text_size, Colo
 
 inline void drawingDrawCenteredText(Vector2* position, Font* font, float text_size, Color* color, bool outlined, Color* outline_color, std::string_view text) {
       auto new_position = *position;
-      auto text_bounds = MeasureTextEx(*font, text.data(), text_size, 0);
+      auto text_bounds = FontLoader::measureText(*font, text.data(), text_size);
       new_position.x -= text_bounds.x / 2.f;
       new_position.y -= text_bounds.y / 2.f;
 
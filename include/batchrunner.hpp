@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bytecodecache.hpp"
+#include "classes/roblox/instance.hpp"
+#include "taskscheduler.hpp"
+
+#include "lua.h"
+
+namespace frostbyte {
+
+// Runs scripts one after another inside a single headless process, so validating many scripts doesn't pay startup for each.
+// A script is done once nothing is queued and none of its threads are parked (on a signal, WaitForChild and the like), or
+// fails once it still has work when the timeout runs out. Its threads are then killed, the instances it added anywhere
+// under the DataModel are destroyed, properties it changed on instances that were already there are put back, connections
+// it made to their signals are disconnected, shared is emptied and the settings it could change are restored.
+// Scripts share the one VM and run in turn rather than side by side: the registries, lookup tables and class data are
+// process-wide and not thread-safe, so a VM per OS thread would need those split first. Each script gets its own
+// sandboxed globals, except under --nosandbox, where globals leak from one script to the next.
+class BatchRunner {
+    // engine settings a script can change from Lua
+    struct Settings {
+        BytecodeCache::Profile compile_profile;
+        ClockMode clock_mode;
+        double fixed_step;
+        rbxInstance::SignalBehavior signal_behavior;
+        int target_fps;
+    };
+    struct Current {
+        size_t index;
+        double start_time = 0.0;
+        bool failed = false;
+        std::string error;
+        // every descendant of the DataModel before the script ran, with its property values at the time
+        std::unordered_map<std::shared_ptr<rbxInstance>, std::vector<rbxValueVariant>> known_instances;
+        uint64_t first_connection; // rbxScriptConnection::next_serial when the script started
+        Settings settings;
+    };
+    static std::unique_ptr<Current> current;
+    static size_t next_index;
+
+    static void startNext(lua_State* L);
+    static void finishCurrent(lua_State* L, const char* timeout_error);
+    static void restoreKnownInstances(lua_State* L);
+    static bool hasParkedThreads();
+public:
+    static std::vector<std::string> paths;
+    static double timeout; // seconds of scheduler time before a script that still has work counts as failed
+    static size_t passed_count;
+    static size_t failed_count;
+
+    // threads that survive between scripts
+    static std::vector<lua_State*> protected_threads;
+
+    // call once per tick; returns false once every script has run
+    static bool step(lua_State* L);
+
+    // reads one script path per line, skipping blank lines and lines starting with #
+    static bool loadList(const char* list_path);
+};
+
+}; // namespace frostbyte
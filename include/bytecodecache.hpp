@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Luau/Compiler.h"
+
+namespace frostbyte {
+
+// Caches compiled bytecode keyed by source, chunk name and compile options, so running the same code again skips the compiler.
+// With disk_enabled, successful compiles are also written under FileSystem::home_path/bytecode/ and survive restarts.
+class BytecodeCache {
+    // entries are found by digest; the source and options are kept so a hit can be told apart from a hash collision
+    struct Entry {
+        std::string options_key;
+        std::string source;
+        std::string bytecode;
+    };
+    static std::unordered_map<uint64_t, Entry> entries;
+    static std::deque<uint64_t> insertion_order; // oldest first
+    static size_t memory_used;
+    static std::mutex mutex;
+
+    static std::string makeOptionsKey(const char* chunk_name, const Luau::CompileOptions& options);
+    static std::string diskPath(uint64_t digest);
+    static bool readDisk(uint64_t digest, const std::string& options_key, const std::string& source, std::string& bytecode);
+    static void writeDisk(uint64_t digest, const std::string& options_key, const std::string& source, const std::string& bytecode);
+    static void insertUnlocked(uint64_t digest, std::string options_key, const std::string& source, const std::string& bytecode);
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t disk_hits = 0;
+        size_t misses = 0;
+    };
+    static Stats stats;
+
+    // the options scripts and loadstring are compiled with, set by --compile= and setcompileoptions
+    struct Profile {
+        int optimization_level = 1; // 2 adds inlining and loop unrolling
+        int debug_level = 1; // 0 drops line info from errors, 2 keeps local and upvalue names
+        int type_info_level = 0; // 1 records types for native code everywhere, not just in --!native scripts
+        std::string vector_lib; // with vector_ctor, calls to vector_lib.vector_ctor(x, y, z) become vector constants
+        std::string vector_ctor;
+        std::string vector_type;
+        std::vector<std::string> mutable_globals; // globals the compiler mustn't assume are constant
+    };
+    static Profile profile;
+    // default (O1), release (O2, for scripts in production) or debug (O0 with local names); false for any other name
+    static bool selectProfile(const char* name);
+
+    static size_t max_memory; // bytes of sources, options and bytecode kept in memory before the oldest entries are dropped
+    static bool disk_enabled;
+
+    // returns bytecode for luau_load; compile errors come back as bytecode too, and luau_load reports them
+    static std::string compile(const std::string& source, const char* chunk_name);
+    static std::string compile(const std::string& source, const char* chunk_name, const Luau::CompileOptions& options);
+
+    static size_t size();
+    static void clear();
+};
+
+}; // namespace frostbyte
@@ -2,15 +2,23 @@
 
 #include "lua.h"
 
+#include <cstdint>
 #include <cstdio>
 #include <functional>
 
 namespace frostbyte {
 
+class rbxScriptSignal;
+
 class rbxScriptConnection {
 public:
     bool alive = true;
     int function_index;
+    rbxScriptSignal* signal = nullptr; // signals are never collected while their connection list exists
+    size_t slot = 0; // index in signal->connection_list
+    uint64_t serial = 0; // order of creation, so connections made after some point can be told apart
+
+    static uint64_t next_serial;
 
     void destroy(lua_State* L);
 };
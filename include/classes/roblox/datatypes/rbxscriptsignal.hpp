@@ -12,11 +12,16 @@ namespace frostbyte {
 class rbxScriptSignal {
 public:
     std::string name;
-    std::vector<rbxScriptConnection> connection_list;
+    // connections by slot; a disconnected slot holds nullptr until the next compaction.
+    // the connection userdata are kept alive by the signal's table in SIGNALCONNECTIONLISTLOOKUP, at slot + 1
+    std::vector<rbxScriptConnection*> connection_list;
+    size_t listener_count = 0; // live connections, so firing can be skipped without touching the connection list
+    size_t firing = 0; // nested fires in progress; slots are only compacted when none are
 };
 
-void pushSignalConnectionList(lua_State* L, int narg);
 int pushNewRBXScriptSignal(lua_State* L, std::string name);
+// called by rbxScriptConnection::destroy
+void detachRBXScriptConnection(lua_State* L, rbxScriptSignal* signal, size_t slot);
 rbxScriptSignal* lua_checkrbxscriptsignal(lua_State* L, int narg);
 
 // push signal, then args, just like a function (NOT REALLY; THIS FUNCTION USES POSITIVE INDEXES AND EXPECTS FUNCTION TO BE AT R1)
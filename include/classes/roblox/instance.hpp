@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cassert>
 #include <functional>
 #include <map>
 #include <memory>
@@ -8,6 +9,7 @@
 #include <shared_mutex>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -57,36 +59,21 @@ struct rbxMethod {
 
 class rbxInstance;
 class rbxValue;
-
-class rbxClass {
-public:
-    static std::map<std::string, std::shared_ptr<rbxClass>> class_map;
-    static std::vector<std::string> valid_class_names;
-    static std::vector<std::string> valid_services;
-
-    std::string name;
-
-    enum Tags : uint8_t {
-        NotCreatable = 1 << 0,
+class rbxScriptSignal;
+
+struct rbxMember {
+    // ordered by precedence when a name is used by more than one kind of member
+    enum Kind : uint8_t {
+        None,
+        Event,
+        Method,
+        Property
     };
-    uint8_t tags = 0;
-
-    std::shared_ptr<rbxClass> superclass;
-    std::map<std::string, std::shared_ptr<rbxProperty>> properties;
-    std::map<std::string, rbxMethod> methods;
-    std::vector<std::string> events;
-    std::function<void(lua_State* L, std::shared_ptr<rbxInstance> instance)> constructor = nullptr;
-    std::function<void(rbxInstance*)> destructor = nullptr;
-
-    void newMethod(const char* name, lua_CFunction func, lua_Continuation cont = nullptr) {
-        rbxMethod method;
-        method.name = name;
-        method.func = func;
-        method.cont = cont;
-        methods.try_emplace(name, method);
-    }
+    Kind kind = None;
 
-    std::shared_ptr<rbxProperty> newInternalProperty(const char* name, TypeCategory type_category, rbxValue default_value);
+    size_t slot = 0; // the property's own slot, or the event's index in all_events
+    size_t value_slot = 0; // where its value lives; differs from slot for routed (deprecated alias) properties
+    rbxMethod* method = nullptr; // route already resolved
 };
 
 struct rbxCallback {
@@ -122,11 +109,68 @@ typedef std::variant<
     Vector3
 > rbxValueVariant;
 
+class rbxClass {
+public:
+    static std::map<std::string, std::shared_ptr<rbxClass>> class_map;
+    static std::vector<std::string> valid_class_names;
+    static std::vector<std::string> valid_services;
+
+    std::string name;
+
+    enum Tags : uint8_t {
+        NotCreatable = 1 << 0,
+    };
+    uint8_t tags = 0;
+
+    std::shared_ptr<rbxClass> superclass;
+    std::map<std::string, std::shared_ptr<rbxProperty>> properties;
+    std::map<std::string, rbxMethod> methods;
+    std::vector<std::string> events;
+    std::function<void(lua_State* L, std::shared_ptr<rbxInstance> instance)> constructor = nullptr;
+    std::function<void(rbxInstance*)> destructor = nullptr;
+
+    // flattened property layout built by finalize(): superclass slots come first, so an inherited property
+    // has the same slot in every subclass. instances store their values in a vector indexed by slot.
+    bool finalized = false;
+    std::vector<std::shared_ptr<rbxProperty>> slots;
+    std::map<std::string, size_t, std::less<>> slot_map;
+    std::vector<rbxValueVariant> default_values;
+    std::vector<std::string> all_events; // own and inherited; superclass events come first like slots
+
+    // dense id assigned by finalize(); a superclass is always finalized first, so its id is lower
+    static size_t class_count;
+    size_t id = 0;
+    std::vector<bool> ancestry; // by class id: set for this class and each of its superclasses
+
+    // finalized classes by the MemberAtoms atom of their name
+    static std::vector<rbxClass*> class_by_atom;
+    static rbxClass* find(const char* name, int atom = -1);
+
+    void finalize();
+    std::optional<size_t> findSlot(const char* name);
+    size_t getSlot(const char* name);
+
+    // members (including inherited ones) indexed by MemberAtoms atom; built on first lookup
+    std::once_flag members_built;
+    std::vector<uint16_t> member_index; // 1-based index into member_list; 0 means no member
+    std::vector<rbxMember> member_list;
+
+    void buildMembers();
+    const rbxMember* findMember(int atom);
+
+    void newMethod(const char* name, lua_CFunction func, lua_Continuation cont = nullptr) {
+        rbxMethod method;
+        method.name = name;
+        method.func = func;
+        method.cont = cont;
+        methods.try_emplace(name, method);
+    }
+
+    std::shared_ptr<rbxProperty> newInternalProperty(const char* name, TypeCategory type_category, rbxValue default_value);
+};
+
 class rbxValue {
 public:
-    // TODO: setscriptable applies to all instances of a class because each value's property member will point to the same single property shared ptr.
-    // We could get around this by making property an rbxProperty not a shared ptr, but this comes at the cost of memory.
-    // Alternatively, we could just give rbxValue its own tags field that initially copies its property.
     std::shared_ptr<rbxProperty> property;
 
     rbxValueVariant value;
@@ -134,18 +178,53 @@ public:
 
 std::vector<std::weak_ptr<rbxInstance>> getNilInstances();
 
-class rbxInstance {
+class rbxInstance : public std::enable_shared_from_this<rbxInstance> {
 public:
     REGISTER_TYPE(rbxInstance)
 
+    // Immediate fires Changed handlers inside the write that caused them; Deferred queues them until flushDeferredChanges
+    enum class SignalBehavior {
+        Immediate,
+        Deferred
+    };
+    static SignalBehavior signal_behavior;
+    static constexpr int max_deferred_rounds = 10; // changes made by handlers wait for the next flush after this many rounds
+    static size_t deferred_fired_count; // Changed fires dispatched by flushDeferredChanges, for throughput stats
+
     static std::vector<std::weak_ptr<rbxInstance>> instance_list;
     static std::shared_mutex instance_list_mutex;
 
+    // slots of Instance's own properties; these are the same for every class
+    static size_t archivable_slot;
+    static size_t name_slot;
+    static size_t class_name_slot;
+    static size_t parent_slot;
+    static size_t changed_event; // index of Changed in all_events
+
     std::shared_ptr<rbxClass> _class;
-    std::map<std::string, rbxValue> values;
-    std::map<std::string, rbxMethod> methods;
-    std::vector<std::string> events;
+    std::vector<rbxValueVariant> values; // indexed by _class's property slots
     std::vector<std::shared_ptr<rbxInstance>> children;
+    // children keyed by (Name, parenting order), so the first match for a name is the same child a scan of children would find
+    std::map<std::pair<std::string, uint64_t>, std::shared_ptr<rbxInstance>> children_by_name;
+    uint64_t next_child_order = 0;
+    uint64_t child_order = 0; // this instance's order in its parent's children_by_name
+
+    // threads parked in WaitForChild on this instance, by the name they wait for; each holds a ref so the thread stays alive
+    struct ChildWaiter {
+        lua_State* thread;
+        int ref;
+    };
+    std::multimap<std::string, ChildWaiter> child_waiters; // guarded by children_mutex
+
+    // per-instance changes to the class's members (e.g. from setscriptable); created on first write, so most instances never have one
+    struct MemberOverlay {
+        std::map<size_t, uint8_t> property_tags; // by slot
+    };
+    std::unique_ptr<MemberOverlay> overlay;
+
+    // signals are only created once something asks for them; these cache the ones that exist (the Lua side lives in SIGNALLOOKUP)
+    std::vector<rbxScriptSignal*> property_signals; // by slot
+    std::vector<rbxScriptSignal*> event_signals; // by index in _class->all_events
 
     std::shared_mutex values_mutex;
     std::shared_mutex children_mutex;
@@ -165,9 +244,22 @@ public:
     bool isA(rbxClass* target_class);
     bool isA(const char* class_name);
     int pushEvent(lua_State* L, const char* name);
+    int pushPropertySignal(lua_State* L, size_t slot);
+    int pushEventSignal(lua_State* L, size_t index);
+    rbxScriptSignal* getPropertySignal(size_t slot);
+    rbxScriptSignal* getEventSignal(size_t index);
+
+    void reportChanged(lua_State* L, size_t slot);
     void reportChanged(lua_State* L, const char* property);
+    // fires every queued change that is still wanted; called from the main loop
+    static void flushDeferredChanges(lua_State* L);
+
+    uint8_t getPropertyTags(size_t slot);
+    void setPropertyTags(size_t slot, uint8_t tags);
 
     std::shared_ptr<rbxInstance> findFirstChild(std::string name);
+    // call with children_mutex held, after child is in children_by_name under name
+    void wakeChildWaiters(const std::string& name, std::shared_ptr<rbxInstance> child);
 };
 
 #define PROP_INSTANCE_ARCHIVABLE "Archivable"
@@ -179,6 +271,8 @@ public:
 
 void destroyInstance(lua_State* L, std::shared_ptr<rbxInstance> instance, bool dont_remove_from_old_parent_children = false);
 void setInstanceParent(lua_State* L, std::shared_ptr<rbxInstance> instance, std::shared_ptr<rbxInstance> new_parent, bool dont_remove_from_old_parent_children = false, bool dont_set_value = false);
+// keeps parent's children_by_name in sync after child's Name changes
+void renameInstanceChild(std::shared_ptr<rbxInstance> parent, std::shared_ptr<rbxInstance> child, const std::string& old_name, const std::string& new_name);
 
 bool isDescendantOf(std::shared_ptr<rbxInstance> other);
 
@@ -194,14 +288,22 @@ public:
     uint8_t tags = 0;
     bool internal = false;
 
+    std::string name;
+    size_t slot = 0;
+
     TypeCategory type_category;
     rbxValue default_value;
 
     std::optional<std::string> route = std::nullopt;
 };
 
+rbxValueVariant& getInstanceValueVariant(std::shared_ptr<rbxInstance> instance, size_t slot);
 rbxValueVariant& getInstanceValueVariant(std::shared_ptr<rbxInstance> instance, const char* name);
 
+template<typename T>
+T& getInstanceValue(std::shared_ptr<rbxInstance> instance, size_t slot) {
+    return std::get<T>(getInstanceValueVariant(instance, slot));
+}
 template<typename T>
 T& getInstanceValue(std::shared_ptr<rbxInstance> instance, const char* name) {
     return std::get<T>(getInstanceValueVariant(instance, name));
@@ -210,11 +312,13 @@ T& getInstanceValue(std::shared_ptr<rbxInstance> instance, const char* name) {
 rbxValueVariant luaValueToValueVariant(lua_State* L, int idx, rbxValueVariant& reference);
 
 template<typename T>
-void setInstanceValue(std::shared_ptr<rbxInstance> instance, lua_State* L, const char* name, T value, bool dont_report_changed = false) {
+void setInstanceValue(std::shared_ptr<rbxInstance> instance, lua_State* L, size_t slot, T value, bool dont_report_changed = false) {
+    // a slot from an unrelated class would land on some other property of this one
+    assert(slot < instance->_class->slots.size());
+
     std::unique_lock lock(instance->values_mutex);
 
-    auto& rbxvalue = instance->values.at(name);
-    auto& variant = rbxvalue.value;
+    auto& variant = instance->values.at(slot);
 
     if (std::holds_alternative<EnumItemWrapper>(variant)) {
         if constexpr (std::is_same_v<T, std::string>) {
@@ -353,7 +457,7 @@ void setInstanceValue(std::shared_ptr<rbxInstance> instance, lua_State* L, const
             if (value == v)
                 goto DUPLICATE;
 
-            if (strequal(name, PROP_INSTANCE_PARENT)) {
+            if (slot == rbxInstance::parent_slot) {
                 lock.unlock();
                 setInstanceParent(L, instance, value, false, true);
                 lock.lock();
@@ -385,6 +489,20 @@ void setInstanceValue(std::shared_ptr<rbxInstance> instance, lua_State* L, const
 
     #undef handleType
 
+    if constexpr (std::is_same_v<T, std::string>)
+        if (slot == rbxInstance::name_slot) {
+            auto parent = std::get<std::shared_ptr<rbxInstance>>(instance->values[rbxInstance::parent_slot]);
+            std::string old_name = std::move(std::get<std::string>(variant));
+            std::get<std::string>(variant) = value;
+
+            lock.unlock();
+            if (parent)
+                renameInstanceChild(parent, instance, old_name, value);
+            lock.lock();
+
+            goto AFTER_SET;
+        }
+
     std::get<T>(variant) = value;
 
     // TODO: why are these gotos here? (this one and the below DUPLICATE)
@@ -393,17 +511,28 @@ void setInstanceValue(std::shared_ptr<rbxInstance> instance, lua_State* L, const
 
     lock.unlock();
 
-    if (!rbxvalue.property->internal && !dont_report_changed)
-        instance->reportChanged(L, name);
+    if (!dont_report_changed) {
+        auto& property = instance->_class->slots[slot];
+        if (!property->internal)
+            instance->reportChanged(L, slot);
+    }
 
     goto DUPLICATE;
     DUPLICATE: ;
 }
+template<typename T>
+void setInstanceValue(std::shared_ptr<rbxInstance> instance, lua_State* L, const char* name, T value, bool dont_report_changed = false) {
+    setInstanceValue<T>(instance, L, instance->_class->getSlot(name), value, dont_report_changed);
+}
 
+void setInstanceValueVariant(std::shared_ptr<rbxInstance> instance, lua_State* L, size_t slot, rbxValueVariant value, bool dont_report_changed = false);
 void setInstanceValueVariant(std::shared_ptr<rbxInstance> instance, lua_State* L, const char* name, rbxValueVariant value, bool dont_report_changed = false);
 
 
+// the rbxClass* overloads skip the class_map lookup; method bodies resolve their class once in their _init instead
+std::shared_ptr<rbxInstance>& lua_checkinstance(lua_State* L, int narg, rbxClass* target_class);
 std::shared_ptr<rbxInstance>& lua_checkinstance(lua_State* L, int narg, const char* class_name = nullptr);
+std::shared_ptr<rbxInstance> lua_optinstance(lua_State* L, int narg, rbxClass* target_class);
 std::shared_ptr<rbxInstance> lua_optinstance(lua_State* L, int narg, const char* class_name = nullptr);
 
 void rbxInstanceSetup(lua_State* L, std::string api_jump);
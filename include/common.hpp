@@ -33,6 +33,8 @@ enum LuaTag {
 };
 
 extern bool print_stdout;
+// set by --headless: there is no window or GPU, so nothing is rendered and textures are never uploaded
+extern bool headless;
 
 int countDecimals(double value);
 #define decimalFmt(value) countDecimals(value), value
@@ -71,8 +73,13 @@ int pushFromLookup(lua_State* L, const char* lookup, std::function<void()> pushK
 int pushFromLookup(lua_State* L, const char* lookup, void* ptr, std::function<void()> pushValue);
 
 int pushFunctionFromLookup(lua_State* L, lua_CFunction func, const char* name = nullptr, lua_Continuation cont = nullptr);
+// push a strong lookup table that is never collected, call registerLookup; the table is left on the stack
+void registerLookup(lua_State* L);
 // push lookup, call addToLookup, lookup is popped by addToLookup
+// values are deduplicated by identity; in registered lookups they're also reference counted, and the index stays valid until every add is released
 int addToLookup(lua_State *L, std::function<void()> pushValue, bool keep_value = false);
+// push lookup, call releaseFromLookup, lookup is popped; in registered lookups the index is only freed once its last reference is released
+void releaseFromLookup(lua_State* L, int index);
 
 template<class T>
 void pushNewSharedPtrObject(lua_State* L, std::shared_ptr<T>& ptr) {
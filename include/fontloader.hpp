@@ -25,6 +25,9 @@ public:
 
     static const char* getFontType(unsigned char* data, int data_size);
     static size_t getFont(unsigned char* data, int data_size);
+
+    // MeasureTextEx, except headless fonts (which have no glyphs) measure as zero instead of being read
+    static Vector2 measureText(const Font& font, const char* text, float size);
 };
 
 }; // namespace frostbyte
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "lua.h"
+
+namespace frostbyte {
+
+// Interns instance member names (properties, methods and events) as Luau string atoms.
+// Luau stores the atom on every string it creates, so __index and __namecall can find a member without hashing the key.
+class MemberAtoms {
+    using AtomMap = std::unordered_map<std::string_view, int16_t>;
+
+    static std::deque<std::string> names; // deque so the string_view keys below stay valid
+    // the last map is current. once frozen, a name interned later goes into a copy instead, and older maps are kept
+    // because a lookup that skipped the lock may still be reading one
+    static std::deque<AtomMap> atom_maps;
+    static std::atomic<const AtomMap*> frozen_map; // published by freeze(); lookups read it without taking mutex
+    static std::shared_mutex mutex;
+
+    static int16_t findIn(const AtomMap& map, std::string_view name);
+public:
+    static constexpr int16_t NO_ATOM = -1;
+
+    static int16_t intern(std::string_view name);
+    // called by the useratom callback on every string Luau creates
+    static int16_t find(const char* s, size_t l);
+    static const std::string& name(int16_t atom);
+    static size_t count();
+
+    // registers the useratom callback; names interned before this is called only apply to strings created afterwards
+    static void install(lua_State* L);
+    // assigns atoms to existing strings whose names were interned after they were created
+    static void retag(lua_State* L);
+    // call once setup has interned the api dump; from then on find doesn't lock, and intern (only lazily finalized
+    // classes still do) copies the map rather than changing it
+    static void freeze();
+};
+
+}; // namespace frostbyte
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+#include "lua.h"
+
+namespace frostbyte {
+
+// Compiles loaded chunks to machine code with Luau's CodeGen backend, falling back to the interpreter when it can't.
+// With enabled set, every chunk is compiled; otherwise only scripts marked with --!native (or @native functions) are.
+// Native code only runs while single-step mode is off, so turning the stephook on sends everything back to the interpreter.
+class NativeCode {
+public:
+    struct Stats {
+        size_t chunks = 0; // chunks that produced any native code
+        size_t functions_total = 0;
+        size_t functions_compiled = 0;
+        size_t failures = 0; // functions the backend gave up on; they stay interpreted
+        size_t code_bytes = 0;
+    };
+    static Stats stats;
+
+    static bool enabled;
+
+    // whether this CPU and build have a backend; false if setup hasn't run yet
+    static bool isSupported();
+
+    // call on the main state before any code is loaded
+    static void setup(lua_State* L);
+    // compiles the function at idx (as left by luau_load) and its nested functions
+    static void compile(lua_State* L, int idx);
+private:
+    static bool supported;
+};
+
+}; // namespace frostbyte
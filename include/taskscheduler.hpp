@@ -1,6 +1,13 @@
 #pragma once
 
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
 #include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "common.hpp"
@@ -24,13 +31,21 @@ struct TaskTiming {
     enum {
         Instant,
         Wait,
-        Delay
+        Delay,
+        Timeout // like Delay, but the thread can be woken early with wakeThread
     } type = Instant;
 
     double start_time = 0.0;
     double count = 0.0;
 };
 
+// where the scheduler and services get their time from
+enum class ClockMode {
+    Real, // the wall clock
+    FixedStep, // fixed_step per frame
+    NextDeadline // like FixedStep, but frames with nothing ready skip to the earliest waiting thread's deadline
+};
+
 enum ThreadCapability {
     LOWEST_CAPABILITY,
 
@@ -46,6 +61,8 @@ enum ThreadCapability {
     HIGHEST_CAPABILTY = NOT_ACCESSIBLE_SECURITY
 };
 
+using Workload = std::function<int(lua_State*)>;
+
 struct Task {
     TaskStatus status;
     lua_State* parent;
@@ -54,6 +71,7 @@ struct Task {
     std::string identifier;
 
     bool canceled;
+    bool killed = false; // set by killThread; work that finishes for a killed thread doesn't push its results
     int ref;
     int arg_count;
     TaskTiming timing;
@@ -61,24 +79,100 @@ struct Task {
     // TODO: maybe just always use console and remove feedback
     Feedback feedback;
     OnKill on_kill;
+    Workload on_timeout; // for TaskTiming::Timeout; returns the thread's result count
+    OnKill on_abandon; // for TaskTiming::Timeout; undoes whatever parked the thread if it's killed or canceled before it resumes
 
     ThreadCapability capability = NONE;
 
+    bool recyclable = false; // signal handler threads go back to the idle pool when they finish
+
     struct {
         bool open = false;
     } view;
+
+    // hooks for TaskScheduler::thread_list; guarded by thread_list_mutex
+    lua_State* thread = nullptr;
+    Task* prev = nullptr;
+    Task* next = nullptr;
+    bool listed = false;
 };
 
-using Workload = std::function<int(lua_State*)>;
+// live threads, linked through their Tasks so registering and removing one doesn't search the list
+class ThreadList {
+    Task* head = nullptr;
+    Task* tail = nullptr;
+    size_t count = 0;
+public:
+    class iterator {
+        Task* task;
+    public:
+        explicit iterator(Task* task) : task(task) {}
+
+        lua_State* operator*() const { return task->thread; }
+        iterator& operator++() {
+            task = task->next;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return task == other.task; }
+        bool operator!=(const iterator& other) const { return task != other.task; }
+    };
+
+    iterator begin() const { return iterator(head); }
+    iterator end() const { return iterator(nullptr); }
+    size_t size() const { return count; }
+
+    void push_back(Task* task);
+    // returns false if task wasn't in the list
+    bool erase(Task* task);
+    void clear();
+};
 
 class TaskScheduler {
     static std::shared_mutex target_fps_mutex;
 
     static std::shared_mutex gc_mutex;
 
-    static std::vector<lua_State*> thread_queue;
+    // each queued thread has one live entry, identified by the generation in queued_threads;
+    // entries left behind by a kill or an early wake are dropped when they come up
+    struct TimedThread {
+        double wake_time;
+        uint64_t generation;
+        lua_State* thread;
+
+        bool operator>(const TimedThread& other) const {
+            return wake_time > other.wake_time || (wake_time == other.wake_time && generation > other.generation);
+        }
+    };
+    static std::unordered_map<lua_State*, uint64_t> queued_threads;
+    static std::deque<std::pair<lua_State*, uint64_t>> ready_queue; // Instant timings, in queue order
+    static std::priority_queue<TimedThread, std::vector<TimedThread>, std::greater<TimedThread>> timer_heap; // by wake time
+    static uint64_t next_generation;
     static std::shared_mutex thread_queue_mutex;
 
+    static void queueThreadUnlocked(lua_State* thread);
+    static bool takeQueuedUnlocked(lua_State* thread, uint64_t generation);
+
+    // finished yieldForWork jobs, drained by run() on the main thread
+    struct CompletedWork {
+        lua_State* thread;
+        int ref; // keeps thread alive while its work runs
+        Workload push_results;
+        std::optional<std::string> error;
+    };
+    static std::vector<CompletedWork> completed_work;
+    static std::mutex completed_work_mutex;
+    static size_t outstanding_work; // submitted jobs whose threads have not been handed their results yet; main thread only
+
+    static void resumeCompletedWork();
+
+    // finished signal handler threads, ready to run the next handler; they keep their ref but leave thread_list
+    static std::vector<lua_State*> idle_handler_threads;
+    static constexpr size_t max_idle_handler_threads = 64;
+
+    static ClockMode clock_mode;
+    static double clock_time; // current time while simulated
+    static double clock_offset; // added to lua_clock in Real mode, so time never goes back after leaving a simulated mode
+
     static void resumeThread(lua_State* thread);
     static void killThreadUnlocked(lua_State* thread);
 public:
@@ -89,12 +183,37 @@ public:
 
     static lua_State* mainL;
 
-    static std::vector<lua_State*> thread_list;
+    static ThreadList thread_list;
     static std::shared_mutex thread_list_mutex;
 
     static int target_fps;
     static void setTargetFps(int target);
 
+    // simulated clocks move fixed_step per frame
+    static double fixed_step;
+    static ClockMode getClockMode();
+    static void setClockMode(ClockMode mode);
+    static double getTime();
+    // moves simulated time forward; call once at the start of every frame
+    static void advanceClock();
+
+    // share of a frame at target_fps that run() may spend resuming threads before leaving the rest for the next run.
+    // 0 (the default, set by --frame-budget) means no limit, so every ready thread resumes in the frame it became ready
+    static double frame_budget_share;
+    struct RunStats {
+        size_t resumed = 0; // threads resumed by the last run
+        size_t carried = 0; // ready threads the last run left queued because the budget ran out
+        uint64_t over_budget_runs = 0;
+    };
+    static RunStats run_stats;
+
+    // seconds a single resume may run before the interrupt callback steps in; 0 disables the watchdog.
+    // over budget threads are requeued at their next call or loop iteration, or get an error when kill_over_budget is set.
+    // code that can't yield there (coroutines, metamethods) gets the error after unyieldable_budget_factor times the budget
+    static double resume_budget;
+    static bool kill_over_budget;
+    static constexpr double unyieldable_budget_factor = 10.0;
+
     static bool gcShouldRun(lua_State* L);
     static bool gcActuallyPaused(lua_State* L);
     static void gcCollect(lua_State* L);
@@ -103,8 +222,28 @@ public:
 
     static void performGCWork(lua_State* L, std::function<void()> work);
 
+    // runs incremental GC steps in the time left before deadline (lua_clock), stopping early when a cycle finishes.
+    // does about as much collector work as was allocated since the last call (less if the deadline comes first), so the
+    // collector keeps up with allocation and allocation-triggered steps rarely land in the middle of a frame.
+    // a new cycle only starts once enough allocation has built up
+    static void gcIdleStep(lua_State* L, double deadline);
+    static bool idle_gc;
+    struct GCStats {
+        double time = 0.0; // seconds spent by the last gcIdleStep
+        size_t steps = 0;
+        int step_kb = 0;
+        size_t allocated = 0; // bytes the heap grew by between the last two calls
+        size_t debt = 0; // bytes of allocation left for later calls to pay for
+    };
+    static GCStats gc_stats;
+
     static lua_State* newThread(lua_State* L, Feedback feedback, OnKill on_kill = nullptr);
     static void killThread(lua_State* thread);
+    // for threads that ran to completion; recyclable ones are parked for reuse instead of killed
+    static void finishThread(lua_State* thread);
+
+    // runs the function below arg_count arguments at the top of L like task.spawn, reusing an idle handler thread if there is one
+    static void spawnHandler(lua_State* L, int arg_count);
 
     static void queueThread(lua_State* thread);
     static void queueForResume(lua_State* thread, int arg_count);
@@ -114,9 +253,17 @@ public:
     static void startCodeOnNewThread(lua_State* L, const char* chunk_name, const char* code, size_t code_size, Feedback feedback, OnKill on_kill = nullptr, Console* console = nullptr);
 
     static int yieldThread(lua_State* thread);
-    static int yieldForWork(lua_State* thread, Workload work);
+    // runs work on the worker pool; the Workload it returns pushes the thread's results from the main thread
+    static int yieldForWork(lua_State* thread, std::function<Workload()> work);
+    // parks thread until wakeThread is called, or until timeout seconds pass and on_timeout provides its results.
+    // on_abandon runs instead of either if the thread is killed or canceled while parked
+    static int yieldWithTimeout(lua_State* thread, double timeout, Workload on_timeout, OnKill on_abandon = nullptr);
+    // resumes a thread parked by yieldWithTimeout on the next run with the arg_count values pushed onto it
+    static void wakeThread(lua_State* thread, int arg_count);
 
     static void run();
+    // whether a thread is queued or waiting on the worker pool; threads parked on signals don't count
+    static bool hasPendingWork();
 
     static void cleanup();
 };
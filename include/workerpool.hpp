@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace frostbyte {
+
+// Fixed set of threads for blocking work (HTTP requests and the like), started on first use.
+// Each worker has its own queue and steals from the back of the others' when it runs dry.
+// Jobs must not touch Lua; hand results back through TaskScheduler::yieldForWork.
+class WorkerPool {
+public:
+    using Job = std::function<void()>;
+
+    static void submit(Job job);
+    // waits for running jobs; jobs that haven't started are dropped
+    static void stop();
+private:
+    struct Worker {
+        std::deque<Job> jobs;
+        std::mutex mutex;
+        std::thread thread;
+    };
+
+    static std::vector<std::unique_ptr<Worker>> workers;
+    static std::atomic<size_t> next_worker;
+
+    static std::mutex sleep_mutex;
+    static std::condition_variable wake;
+    static size_t pending; // queued but not yet claimed by a worker; guarded by sleep_mutex
+    static bool stopping;
+
+    static void start();
+    static bool take(size_t index, Job& job);
+    static void run(size_t index);
+};
+
+}; // namespace frostbyte
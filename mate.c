@@ -22,6 +22,7 @@ int main() {
 
     AddIncludePaths(executable, "./dependencies/Luau/Analysis/include");
     AddIncludePaths(executable, "./dependencies/Luau/Ast/include");
+    AddIncludePaths(executable, "./dependencies/Luau/CodeGen/include");
     AddIncludePaths(executable, "./dependencies/Luau/Common/include");
     AddIncludePaths(executable, "./dependencies/Luau/Compiler/include");
     AddIncludePaths(executable, "./dependencies/Luau/Config/include");
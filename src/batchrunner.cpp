@@ -0,0 +1,224 @@
+#include "batchrunner.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include "classes/roblox/datamodel.hpp"
+#include "classes/roblox/datatypes/rbxscriptconnection.hpp"
+#include "classes/roblox/datatypes/rbxscriptsignal.hpp"
+
+namespace frostbyte {
+
+std::unique_ptr<BatchRunner::Current> BatchRunner::current;
+size_t BatchRunner::next_index = 0;
+std::vector<std::string> BatchRunner::paths;
+double BatchRunner::timeout = 30.0;
+size_t BatchRunner::passed_count = 0;
+size_t BatchRunner::failed_count = 0;
+std::vector<lua_State*> BatchRunner::protected_threads;
+
+bool BatchRunner::loadList(const char* list_path) {
+    std::ifstream file(list_path);
+    if (!file) {
+        fprintf(stderr, "ERROR: failed to open batch list %s\n", list_path);
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+        paths.push_back(line);
+    }
+    return true;
+}
+
+// calls visit on every descendant of instance; visit returns whether to look inside the descendant too
+template<typename Visit>
+static void forEachDescendant(const std::shared_ptr<rbxInstance>& instance, Visit visit) {
+    std::shared_lock children_lock(instance->children_mutex);
+    for (auto& child : instance->children)
+        if (visit(child))
+            forEachDescendant(child, visit);
+}
+
+void BatchRunner::startNext(lua_State* L) {
+    current = std::make_unique<Current>();
+    current->index = next_index++;
+    current->start_time = TaskScheduler::getTime();
+
+    forEachDescendant(DataModel::instance, [] (const std::shared_ptr<rbxInstance>& instance) {
+        std::shared_lock values_lock(instance->values_mutex);
+        current->known_instances.emplace(instance, instance->values);
+        return true;
+    });
+    current->first_connection = rbxScriptConnection::next_serial;
+
+    current->settings = Settings{
+        .compile_profile = BytecodeCache::profile,
+        .clock_mode = TaskScheduler::getClockMode(),
+        .fixed_step = TaskScheduler::fixed_step,
+        .signal_behavior = rbxInstance::signal_behavior,
+        .target_fps = TaskScheduler::target_fps
+    };
+
+    const std::string& path = paths[current->index];
+    try {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("failed to open file");
+        std::stringstream contents;
+        contents << file.rdbuf();
+        const std::string code = contents.str();
+
+        const size_t index = current->index;
+        TaskScheduler::startCodeOnNewThread(L, path.c_str(), code.c_str(), code.length(), [index] (std::string error) {
+            // a script can only report after it finished if one of its threads outlived the cleanup below
+            if (!current || current->index != index || current->failed)
+                return;
+            current->failed = true;
+            current->error = std::move(error);
+        });
+    } catch (std::exception& e) {
+        current->failed = true;
+        current->error = e.what();
+    }
+}
+
+void BatchRunner::finishCurrent(lua_State* L, const char* timeout_error) {
+    if (timeout_error && !current->failed) {
+        current->failed = true;
+        current->error = timeout_error;
+    }
+
+    const std::string& path = paths[current->index];
+    if (current->failed) {
+        failed_count++;
+        printf("[FAIL] %s: %s\n", path.c_str(), current->error.c_str());
+    } else {
+        passed_count++;
+        printf("[PASS] %s\n", path.c_str());
+    }
+
+    // killThread takes thread_list_mutex itself, so collect the threads first
+    std::vector<lua_State*> threads;
+    {
+        std::shared_lock lock(TaskScheduler::thread_list_mutex);
+        for (lua_State* thread : TaskScheduler::thread_list)
+            if (std::find(protected_threads.begin(), protected_threads.end(), thread) == protected_threads.end())
+                threads.push_back(thread);
+    }
+    for (lua_State* thread : threads)
+        TaskScheduler::killThread(thread);
+
+    // before looking for added instances, so a known instance the script moved under one of them isn't destroyed along with it
+    restoreKnownInstances(L);
+
+    // anything the script put in the tree goes with it; destroying an added instance takes its descendants too
+    std::vector<std::shared_ptr<rbxInstance>> added;
+    forEachDescendant(DataModel::instance, [&added] (const std::shared_ptr<rbxInstance>& instance) {
+        if (current->known_instances.count(instance))
+            return true;
+        added.push_back(instance);
+        return false;
+    });
+    for (auto& instance : added)
+        destroyInstance(L, instance);
+
+    lua_getglobal(L, "shared");
+    if (lua_istable(L, -1))
+        lua_cleartable(L, -1);
+    lua_pop(L, 1);
+
+    const Settings& settings = current->settings;
+    BytecodeCache::profile = settings.compile_profile;
+    if (TaskScheduler::getClockMode() != settings.clock_mode)
+        TaskScheduler::setClockMode(settings.clock_mode);
+    TaskScheduler::fixed_step = settings.fixed_step;
+    rbxInstance::signal_behavior = settings.signal_behavior;
+    if (TaskScheduler::target_fps != settings.target_fps)
+        TaskScheduler::setTargetFps(settings.target_fps);
+
+    current.reset();
+}
+
+void BatchRunner::restoreKnownInstances(lua_State* L) {
+    for (auto& [instance, values] : current->known_instances) {
+        bool parent_locked;
+        {
+            std::shared_lock parent_locked_lock(instance->parent_locked_mutex);
+            parent_locked = instance->parent_locked;
+        }
+
+        // Changed isn't fired; nothing that listened to it during the script is still around
+        for (size_t slot = 0; slot < values.size(); slot++) {
+            const rbxValueVariant& value = values[slot];
+            if (std::holds_alternative<rbxCallback>(value)) {
+                // callbacks can't go through setValue, and only their lookup index changes
+                std::unique_lock values_lock(instance->values_mutex);
+                std::get<rbxCallback>(instance->values[slot]) = std::get<rbxCallback>(value);
+            } else if (std::holds_alternative<EnumItemWrapper>(value))
+                setInstanceValue<std::string>(instance, L, slot, std::get<EnumItemWrapper>(value).name, true);
+            else if (slot == rbxInstance::parent_slot && parent_locked)
+                continue; // destroyed by the script (or locked from the start, in which case it can't have moved)
+            else
+                setInstanceValueVariant(instance, L, slot, value, true);
+        }
+
+        // collected first since destroying a connection can compact the list it's in
+        std::vector<rbxScriptConnection*> connections;
+        auto collect = [&connections] (const std::vector<rbxScriptSignal*>& signals) {
+            for (rbxScriptSignal* signal : signals) {
+                if (!signal)
+                    continue;
+                for (rbxScriptConnection* connection : signal->connection_list)
+                    if (connection && connection->serial >= current->first_connection)
+                        connections.push_back(connection);
+            }
+        };
+        collect(instance->event_signals);
+        collect(instance->property_signals);
+        for (rbxScriptConnection* connection : connections)
+            connection->destroy(L);
+    }
+}
+
+// hasPendingWork doesn't count threads parked on signals, but a script waiting on one isn't finished yet
+bool BatchRunner::hasParkedThreads() {
+    std::shared_lock lock(TaskScheduler::thread_list_mutex);
+    for (lua_State* thread : TaskScheduler::thread_list) {
+        if (std::find(protected_threads.begin(), protected_threads.end(), thread) != protected_threads.end())
+            continue;
+        if (getTask(thread)->status >= YIELDING)
+            return true;
+    }
+    return false;
+}
+
+bool BatchRunner::step(lua_State* L) {
+    if (current) {
+        // a script that ran out of work on the tick the timeout ran out still passes
+        const bool has_work = !current->failed && (TaskScheduler::hasPendingWork() || hasParkedThreads());
+        if (!has_work)
+            finishCurrent(L, nullptr);
+        else if (TaskScheduler::getTime() - current->start_time >= timeout)
+            finishCurrent(L, "timed out");
+        else
+            return true;
+    }
+
+    if (next_index >= paths.size())
+        return false;
+
+    startNext(L);
+    return true;
+}
+
+}; // namespace frostbyte
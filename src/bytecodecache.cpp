@@ -0,0 +1,231 @@
+#include "bytecodecache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "libraries/filesystemlib.hpp"
+
+#include "Luau/Bytecode.h"
+
+namespace frostbyte {
+
+std::unordered_map<uint64_t, BytecodeCache::Entry> BytecodeCache::entries;
+std::deque<uint64_t> BytecodeCache::insertion_order;
+size_t BytecodeCache::memory_used = 0;
+std::mutex BytecodeCache::mutex;
+BytecodeCache::Stats BytecodeCache::stats;
+size_t BytecodeCache::max_memory = 64 * 1024 * 1024;
+bool BytecodeCache::disk_enabled = false;
+BytecodeCache::Profile BytecodeCache::profile;
+
+// frostbyte's datatypes, so the type info pass can tell them apart from other userdata. this only feeds native code
+// type info; none of frostbyte's libraries are registered as known members, so nothing of theirs gets constant folded
+static const char* const userdata_types[] = {
+    "Color3", "ColorSequence", "ColorSequenceKeypoint", "NumberRange", "NumberSequence", "NumberSequenceKeypoint",
+    "Rect", "TweenInfo", "UDim", "UDim2", "Vector2", "Vector3", "Instance", "RBXScriptSignal", "RBXScriptConnection",
+    nullptr
+};
+
+static constexpr uint32_t DISK_MAGIC = 0x43424246; // "FBBC"
+
+// FNV-1a; entries and disk files are found by one seed and disk files are checked against the other
+static uint64_t hashString(const std::string& s, uint64_t seed) {
+    uint64_t hash = seed;
+    for (unsigned char c : s) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+static constexpr uint64_t NAME_SEED = 0xcbf29ce484222325ull;
+static constexpr uint64_t CHECK_SEED = 0x84222325cbf29ce4ull;
+
+// hashes the options and then the source in one pass over each, without joining them into one string first
+static uint64_t digestOf(const std::string& options_key, const std::string& source, uint64_t seed) {
+    return hashString(source, hashString(options_key, seed));
+}
+
+static void appendOption(std::string& key, const char* value) {
+    if (value)
+        key.append(value);
+    key.push_back('\0');
+}
+static void appendOptionList(std::string& key, const char* const* list) {
+    for (; list && *list; list++)
+        appendOption(key, *list);
+    key.push_back('\0');
+}
+
+// the bytecode version goes in too, so files written by an older Luau aren't loaded by a newer one
+std::string BytecodeCache::makeOptionsKey(const char* chunk_name, const Luau::CompileOptions& options) {
+    std::string key;
+
+    key.append(std::to_string(LBC_VERSION_TARGET)).push_back(',');
+    key.append(std::to_string(LBC_TYPE_VERSION_TARGET)).push_back(',');
+    key.append(std::to_string(options.optimizationLevel)).push_back(',');
+    key.append(std::to_string(options.debugLevel)).push_back(',');
+    key.append(std::to_string(options.typeInfoLevel)).push_back(',');
+    key.append(std::to_string(options.coverageLevel)).push_back('\0');
+    appendOption(key, options.vectorLib);
+    appendOption(key, options.vectorCtor);
+    appendOption(key, options.vectorType);
+    appendOptionList(key, options.mutableGlobals);
+    appendOptionList(key, options.userdataTypes);
+
+    appendOption(key, chunk_name);
+    return key;
+}
+
+std::string BytecodeCache::diskPath(uint64_t digest) {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(digest));
+
+    std::string path = FileSystem::home_path;
+    path.append("bytecode/").append(name);
+    return path;
+}
+
+bool BytecodeCache::readDisk(uint64_t digest, const std::string& options_key, const std::string& source, std::string& bytecode) {
+    std::ifstream file(diskPath(digest), std::ios::binary);
+    if (!file)
+        return false;
+
+    uint32_t magic;
+    uint64_t key_size, check;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+    file.read(reinterpret_cast<char*>(&check), sizeof(check));
+    if (!file || magic != DISK_MAGIC || key_size != options_key.size() + source.size() || check != digestOf(options_key, source, CHECK_SEED))
+        return false;
+
+    bytecode.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !bytecode.empty();
+}
+
+// a cache that can't be written is just a slower cache, so failures here are ignored
+void BytecodeCache::writeDisk(uint64_t digest, const std::string& options_key, const std::string& source, const std::string& bytecode) {
+    std::error_code error;
+    std::filesystem::create_directories(FileSystem::home_path + "bytecode/", error);
+    if (error)
+        return;
+
+    const std::string path = diskPath(digest);
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return;
+
+        const uint32_t magic = DISK_MAGIC;
+        const uint64_t key_size = options_key.size() + source.size();
+        const uint64_t check = digestOf(options_key, source, CHECK_SEED);
+        file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+        file.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+        file.write(reinterpret_cast<const char*>(&check), sizeof(check));
+        file.write(bytecode.data(), bytecode.size());
+        if (!file)
+            return;
+    }
+    // renamed into place so another process never reads half a file
+    std::filesystem::rename(tmp_path, path, error);
+}
+
+// a digest already taken by some other source keeps its entry; the newcomer just isn't cached
+void BytecodeCache::insertUnlocked(uint64_t digest, std::string options_key, const std::string& source, const std::string& bytecode) {
+    const size_t entry_size = options_key.size() + source.size() + bytecode.size();
+    if (entry_size > max_memory || entries.count(digest))
+        return;
+
+    while (memory_used + entry_size > max_memory && !insertion_order.empty()) {
+        auto it = entries.find(insertion_order.front());
+        memory_used -= it->second.options_key.size() + it->second.source.size() + it->second.bytecode.size();
+        entries.erase(it);
+        insertion_order.pop_front();
+    }
+
+    entries.emplace(digest, Entry{ std::move(options_key), source, bytecode });
+    insertion_order.push_back(digest);
+    memory_used += entry_size;
+}
+
+bool BytecodeCache::selectProfile(const char* name) {
+    Profile selected;
+    if (strcmp(name, "release") == 0)
+        selected.optimization_level = 2;
+    else if (strcmp(name, "debug") == 0) {
+        selected.optimization_level = 0;
+        selected.debug_level = 2;
+    } else if (strcmp(name, "default") != 0)
+        return false;
+
+    profile = selected;
+    return true;
+}
+
+std::string BytecodeCache::compile(const std::string& source, const char* chunk_name) {
+    std::vector<const char*> mutable_globals;
+    for (auto& name : profile.mutable_globals)
+        mutable_globals.push_back(name.c_str());
+    mutable_globals.push_back(nullptr);
+
+    Luau::CompileOptions options;
+    options.optimizationLevel = profile.optimization_level;
+    options.debugLevel = profile.debug_level;
+    options.typeInfoLevel = profile.type_info_level;
+    options.vectorLib = profile.vector_lib.empty() ? nullptr : profile.vector_lib.c_str();
+    options.vectorCtor = profile.vector_ctor.empty() ? nullptr : profile.vector_ctor.c_str();
+    options.vectorType = profile.vector_type.empty() ? nullptr : profile.vector_type.c_str();
+    options.mutableGlobals = mutable_globals.data();
+    options.userdataTypes = userdata_types;
+
+    return compile(source, chunk_name, options);
+}
+
+std::string BytecodeCache::compile(const std::string& source, const char* chunk_name, const Luau::CompileOptions& options) {
+    std::string options_key = makeOptionsKey(chunk_name, options);
+    const uint64_t digest = digestOf(options_key, source, NAME_SEED);
+
+    {
+        std::lock_guard lock(mutex);
+        auto it = entries.find(digest);
+        if (it != entries.end() && it->second.options_key == options_key && it->second.source == source) {
+            stats.hits++;
+            return it->second.bytecode;
+        }
+    }
+
+    std::string bytecode;
+    const bool from_disk = disk_enabled && readDisk(digest, options_key, source, bytecode);
+    if (!from_disk) {
+        bytecode = Luau::compile(source, options);
+
+        // bytecode starting with 0 is a compile error; those are cheap to redo and not worth a file
+        if (disk_enabled && !bytecode.empty() && bytecode[0] != 0)
+            writeDisk(digest, options_key, source, bytecode);
+    }
+
+    std::lock_guard lock(mutex);
+    if (from_disk)
+        stats.disk_hits++;
+    else
+        stats.misses++;
+    insertUnlocked(digest, std::move(options_key), source, bytecode);
+
+    return bytecode;
+}
+
+size_t BytecodeCache::size() {
+    std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+void BytecodeCache::clear() {
+    std::lock_guard lock(mutex);
+    entries.clear();
+    insertion_order.clear();
+    memory_used = 0;
+}
+
+}; // namespace frostbyte
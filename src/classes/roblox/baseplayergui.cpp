@@ -22,6 +22,28 @@ namespace frostbyte {
 
 std::vector<std::shared_ptr<rbxInstance>> gui_storage_list;
 
+// classes and property slots used every frame; resolved once in rbxInstance_BasePlayerGui_init
+static rbxClass* guiobject_class;
+static rbxClass* guibutton_class;
+static rbxClass* layercollector_class;
+
+static size_t absolute_position_slot;
+static size_t absolute_size_slot;
+static size_t absolute_rotation_slot;
+
+static size_t clips_descendants_slot;
+static size_t position_slot;
+static size_t size_slot;
+static size_t rotation_slot;
+static size_t visible_slot;
+static size_t background_color3_slot;
+static size_t background_transparency_slot;
+static size_t border_size_pixel_slot;
+static size_t border_color3_slot;
+static size_t z_index_slot;
+
+static size_t enabled_slot;
+
 // modification of DrawRectanglePro that doesn't fill and allows thickness
 std::array<Vector2, 4> getRectangleLinesPro(Rectangle rec, Vector2 origin, float rotation) {
     // FIXME: this leaves gaps in the corners
@@ -97,7 +119,7 @@ std::map<rbxInstance*, bool> mouse_over_map;
 
 // NOTE: expects Parent
 bool isStorageChild(std::shared_ptr<rbxInstance> instance) {
-    const auto parent = getInstanceValue<std::shared_ptr<rbxInstance>>(instance, PROP_INSTANCE_PARENT);
+    const auto parent = getInstanceValue<std::shared_ptr<rbxInstance>>(instance, rbxInstance::parent_slot);
     assert(parent);
 
     return std::find(gui_storage_list.begin(), gui_storage_list.end(), parent) != gui_storage_list.end();
@@ -116,26 +138,26 @@ void renderGuiObject(lua_State* L, std::shared_ptr<rbxInstance> instance, Vector
     bool clips_descendants = false;
     std::optional<GuiObjectBorder> border_opt;
 
-    const bool is_layer_collector = instance->isA("LayerCollector");
+    const bool is_layer_collector = instance->isA(layercollector_class);
 
     // FIXME: we need to do something about descendants. currently, rotation has no effect. also, clips descendants doesn't do anything.
     // I think we need to render to individual render textures IN REVERSE ORDER?
 
     if (!is_layer_collector) {
-        clips_descendants = getInstanceValue<bool>(instance, "ClipsDescendants");
+        clips_descendants = getInstanceValue<bool>(instance, clips_descendants_slot);
 
-        const auto parent = getInstanceValue<std::shared_ptr<rbxInstance>>(instance, PROP_INSTANCE_PARENT);
+        const auto parent = getInstanceValue<std::shared_ptr<rbxInstance>>(instance, rbxInstance::parent_slot);
         const bool is_storage_child = isStorageChild(parent);
 
         // FIXME: separate function for pos&size calculations that only get called on parent changed?
         // necessary so a newly-created guiobject's Absolute* values are accurate before render
-        auto parent_absolute_position = is_storage_child ? Vector2Zero : getInstanceValue<Vector2>(parent, "AbsolutePosition");
-        auto parent_absolute_size = is_storage_child ? rbxCamera::screen_size : getInstanceValue<Vector2>(parent, "AbsoluteSize");
-        // auto parent_absolute_rotation = is_storage_child ? 0.0f : getInstanceValue<float>(parent, "AbsoluteRotation");
+        auto parent_absolute_position = is_storage_child ? Vector2Zero : getInstanceValue<Vector2>(parent, absolute_position_slot);
+        auto parent_absolute_size = is_storage_child ? rbxCamera::screen_size : getInstanceValue<Vector2>(parent, absolute_size_slot);
+        // auto parent_absolute_rotation = is_storage_child ? 0.0f : getInstanceValue<float>(parent, absolute_rotation_slot);
 
-        auto& position = getInstanceValue<UDim2>(instance, "Position");
-        auto& size = getInstanceValue<UDim2>(instance, "Size");
-        float rotation = getInstanceValue<float>(instance, "Rotation");
+        auto& position = getInstanceValue<UDim2>(instance, position_slot);
+        auto& size = getInstanceValue<UDim2>(instance, size_slot);
+        float rotation = getInstanceValue<float>(instance, rotation_slot);
 
         auto position_x_scale = position.x.scale;
         auto position_y_scale = position.y.scale;
@@ -152,14 +174,14 @@ void renderGuiObject(lua_State* L, std::shared_ptr<rbxInstance> instance, Vector
         // float absolute_rotation = parent_absolute_rotation + rotation;
         float absolute_rotation = rotation;
 
-        setInstanceValue<Vector2>(instance, L, "AbsolutePosition", absolute_position);
-        setInstanceValue<Vector2>(instance, L, "AbsoluteSize", absolute_size);
-        setInstanceValue<float>(instance, L, "AbsoluteRotation", absolute_rotation);
+        setInstanceValue<Vector2>(instance, L, absolute_position_slot, absolute_position);
+        setInstanceValue<Vector2>(instance, L, absolute_size_slot, absolute_size);
+        setInstanceValue<float>(instance, L, absolute_rotation_slot, absolute_rotation);
 
-        if (!getInstanceValue<bool>(instance, "Visible"))
+        if (!getInstanceValue<bool>(instance, visible_slot))
             return;
 
-        auto background_color = getInstanceValue<Color>(instance, "BackgroundColor3");
+        auto background_color = getInstanceValue<Color>(instance, background_color3_slot);
         {
             auto position = auto_button_color_map.find(instance.get());
             if (position != auto_button_color_map.end() && position->second) {
@@ -169,7 +191,7 @@ void renderGuiObject(lua_State* L, std::shared_ptr<rbxInstance> instance, Vector
             }
         }
 
-        background_color.a = (1 - getInstanceValue<float>(instance, "BackgroundTransparency")) * 255;
+        background_color.a = (1 - getInstanceValue<float>(instance, background_transparency_slot)) * 255;
 
         Rectangle shape_rect{
             .x = absolute_position.x + absolute_size.x / 2.f,
@@ -182,9 +204,9 @@ void renderGuiObject(lua_State* L, std::shared_ptr<rbxInstance> instance, Vector
         DrawRectanglePro(shape_rect, shape_origin, absolute_rotation, background_color);
         // DrawRectanglePro(shape_rect, shape_origin, 0.f, background_color);
 
-        auto border_size = getInstanceValue<int>(instance, "BorderSizePixel");
+        auto border_size = getInstanceValue<int>(instance, border_size_pixel_slot);
         if (border_size) {
-            auto border_color = getInstanceValue<Color>(instance, "BorderColor3");
+            auto border_color = getInstanceValue<Color>(instance, border_color3_slot);
             border_color.a = background_color.a;
 
             if (clips_descendants)
@@ -201,7 +223,7 @@ void renderGuiObject(lua_State* L, std::shared_ptr<rbxInstance> instance, Vector
 
         if (is_mouse_over) {
             next_gui_objects_hovered.push_back(instance);
-            if (instance->isA("GuiButton"))
+            if (instance->isA(guibutton_class))
                 next_clickable_instance = instance;
         }
 
@@ -225,16 +247,16 @@ void renderGuiObject(lua_State* L, std::shared_ptr<rbxInstance> instance, Vector
 
         sorted_children.reserve(child_count);
 
-        sorted_children.insert(
-            sorted_children.end(),
-            instance->children.begin(),
-            instance->children.end()
-        );
+        // only GuiObjects have a ZIndex (and a layout), so other children (UI modifiers, scripts, values) are skipped
+        // rather than sorted by whatever sits in the ZIndex slot; nested LayerCollectors are drawn from the render list
+        for (auto& child : instance->children)
+            if (child->isA(guiobject_class))
+                sorted_children.push_back(child);
 
         // TODO: use a std::set if stable sort is still possible (see drawingimmediate)
         // TODO: LayoutOrder?
         std::stable_sort(sorted_children.begin(), sorted_children.end(), [] (std::shared_ptr<rbxInstance> a, std::shared_ptr<rbxInstance> b) {
-            return getInstanceValue<int>(a, "ZIndex") < getInstanceValue<int>(b, "ZIndex");
+            return getInstanceValue<int>(a, z_index_slot) < getInstanceValue<int>(b, z_index_slot);
         });
 
         for (size_t i = 0; i < sorted_children.size(); i++)
@@ -256,9 +278,9 @@ void contributeToRenderList(std::shared_ptr<rbxInstance> instance, bool is_stora
     // FIXME: verify child LayerCollector behavior in terms of DisplayOrder sorting. (if 'a' has higher DisplayOrder than 'b', but a layercollector 'c' parented to 'a' has a lower DisplayOrder than 'b', what happens?)
 
     if (!is_storage) {
-        if (!instance->isA("LayerCollector"))
+        if (!instance->isA(layercollector_class))
             return;
-        if (!getInstanceValue<bool>(instance, "Enabled"))
+        if (!getInstanceValue<bool>(instance, enabled_slot))
             return;
 
         render_list.push_back(instance);
@@ -326,6 +348,30 @@ void rbxInstance_BasePlayerGui_render(lua_State *L, bool anyImGui) {
 
 void rbxInstance_BasePlayerGui_init(lua_State *L, std::initializer_list<std::shared_ptr<rbxInstance>> initial_gui_storage_list) {
     gui_storage_list.insert(gui_storage_list.end(), initial_gui_storage_list.begin(), initial_gui_storage_list.end());
+
+    auto& guibase2d = rbxClass::class_map.at("GuiBase2d");
+    absolute_position_slot = guibase2d->getSlot("AbsolutePosition");
+    absolute_size_slot = guibase2d->getSlot("AbsoluteSize");
+    absolute_rotation_slot = guibase2d->getSlot("AbsoluteRotation");
+
+    auto& guiobject = rbxClass::class_map.at("GuiObject");
+    guiobject_class = guiobject.get();
+    clips_descendants_slot = guiobject->getSlot("ClipsDescendants");
+    position_slot = guiobject->getSlot("Position");
+    size_slot = guiobject->getSlot("Size");
+    rotation_slot = guiobject->getSlot("Rotation");
+    visible_slot = guiobject->getSlot("Visible");
+    background_color3_slot = guiobject->getSlot("BackgroundColor3");
+    background_transparency_slot = guiobject->getSlot("BackgroundTransparency");
+    border_size_pixel_slot = guiobject->getSlot("BorderSizePixel");
+    border_color3_slot = guiobject->getSlot("BorderColor3");
+    z_index_slot = guiobject->getSlot("ZIndex");
+
+    auto& layercollector = rbxClass::class_map.at("LayerCollector");
+    layercollector_class = layercollector.get();
+    enabled_slot = layercollector->getSlot("Enabled");
+
+    guibutton_class = rbxClass::class_map.at("GuiButton").get();
 }
 
 };
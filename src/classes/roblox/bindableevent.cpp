@@ -6,9 +6,11 @@
 
 namespace frostbyte {
 
+static rbxClass* bindableevent_class; // resolved in rbxInstance_BindableEvent_init
+
 namespace rbxInstance_BindableEvent_methods {
     static int fire(lua_State* L) {
-        std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1, "BindableEvent");
+        std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1, bindableevent_class);
         lua_getfield(L, 1, "Event");
         lua_remove(L, 1);
         lua_insert(L, 1);
@@ -20,6 +22,7 @@ namespace rbxInstance_BindableEvent_methods {
 };
 
 void rbxInstance_BindableEvent_init() {
+    bindableevent_class = rbxClass::class_map.at("BindableEvent").get();
     rbxClass::class_map["BindableEvent"]->methods.at("Fire").func = rbxInstance_BindableEvent_methods::fire;
 }
 
@@ -25,10 +25,15 @@
 
 namespace frostbyte {
 
+static rbxClass* boolvalue_class; // resolved in ImGuiService_init
+static rbxClass* intvalue_class;
+static rbxClass* stringvalue_class;
+static rbxClass* color3value_class;
+
 namespace ImGuiService_methods {
     static int begin(lua_State* L) {
         const char* str = luaL_checkstring(L, 1);
-        std::shared_ptr<rbxInstance> boolvalue = lua_optinstance(L, 2, "BoolValue");
+        std::shared_ptr<rbxInstance> boolvalue = lua_optinstance(L, 2, boolvalue_class);
 
         bool* p_open = NULL;
         if (boolvalue)
@@ -60,7 +65,7 @@ namespace ImGuiService_methods {
     }
     static int checkbox(lua_State* L) {
         const char* label = luaL_checkstring(L, 1);
-        std::shared_ptr<rbxInstance> boolvalue = lua_checkinstance(L, 2, "BoolValue");
+        std::shared_ptr<rbxInstance> boolvalue = lua_checkinstance(L, 2, boolvalue_class);
 
         lua_pushboolean(L, ImGui::Checkbox(label, &getInstanceValue<bool>(boolvalue, "Value")));
         return 1;
@@ -82,7 +87,7 @@ namespace ImGuiService_methods {
     }
     static int combo(lua_State* L) {
         const char* label = luaL_checkstring(L, 1);
-        std::shared_ptr<rbxInstance> intvalue = lua_checkinstance(L, 2, "IntValue");
+        std::shared_ptr<rbxInstance> intvalue = lua_checkinstance(L, 2, intvalue_class);
         luaL_checktype(L, 3, LUA_TTABLE);
 
         LuaTable* table = hvalue(luaA_toobject(L, 3));
@@ -111,7 +116,7 @@ namespace ImGuiService_methods {
 
     static int inputText(lua_State* L) {
         const char* label = luaL_checkstring(L, 1);
-        std::shared_ptr<rbxInstance> stringvalue = lua_checkinstance(L, 2, "StringValue");
+        std::shared_ptr<rbxInstance> stringvalue = lua_checkinstance(L, 2, stringvalue_class);
 
         lua_pushboolean(L, ImGui_STDString(label, getInstanceValue<std::string>(stringvalue, "Value")));
         return 1;
@@ -119,7 +124,7 @@ namespace ImGuiService_methods {
 
     static int colorEdit(lua_State* L) {
         const char* label = luaL_checkstring(L, 1);
-        std::shared_ptr<rbxInstance> color3value = lua_checkinstance(L, 2, "Color3Value");
+        std::shared_ptr<rbxInstance> color3value = lua_checkinstance(L, 2, color3value_class);
 
         Color* color = &getInstanceValue<Color>(color3value, "Value");
 
@@ -142,6 +147,11 @@ namespace ImGuiService_methods {
 std::shared_ptr<rbxInstance> ImGuiService;
 
 void ImGuiService_init(lua_State* L, std::shared_ptr<rbxInstance> datamodel) {
+    boolvalue_class = rbxClass::class_map.at("BoolValue").get();
+    intvalue_class = rbxClass::class_map.at("IntValue").get();
+    stringvalue_class = rbxClass::class_map.at("StringValue").get();
+    color3value_class = rbxClass::class_map.at("Color3Value").get();
+
     auto _class = std::make_shared<rbxClass>();
     _class->name.assign("ImGuiService");
     _class->tags |= rbxClass::NotCreatable;
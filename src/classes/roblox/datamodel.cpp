@@ -9,6 +9,9 @@
 #include "lua.h"
 #include "lualib.h"
 
+#include <stdexcept>
+#include <string>
+
 namespace frostbyte {
 
 std::shared_ptr<rbxInstance> DataModel::instance;
@@ -50,16 +53,18 @@ void DataModel::onShutdown(lua_State* L) {
     lua_call(L, 1, 0);
 }
 
+static rbxClass* datamodel_class; // resolved in rbxInstance_DataModel_init
+
 namespace rbxInstance_DataModel_methods {
     static int shutdown(lua_State* L) {
-        lua_checkinstance(L, 1, "DataModel");
+        lua_checkinstance(L, 1, datamodel_class);
 
         DataModel::shutdown = true;
 
         return 0;
     }
     static int bindToClose(lua_State* L) {
-        lua_checkinstance(L, 1, "DataModel");
+        lua_checkinstance(L, 1, datamodel_class);
         luaL_checktype(L, 2, LUA_TFUNCTION);
 
         lua_getfield(L, LUA_REGISTRYINDEX, TOCLOSEBINDS_KEY);
@@ -70,25 +75,31 @@ namespace rbxInstance_DataModel_methods {
         return 0;
     }
     static int httpGet(lua_State* L) {
-        lua_checkinstance(L, 1, "DataModel");
+        lua_checkinstance(L, 1, datamodel_class);
         std::string url = luaL_checkstring(L, 2);
 
-        return TaskScheduler::yieldForWork(L, [url] (lua_State* thread) {
-            struct MemoryStruct chunk;
+        return TaskScheduler::yieldForWork(L, [url] () -> Workload {
+            struct MemoryStruct chunk = { nullptr, 0 };
 
             CURLcode res = newGetRequest(url.c_str(), &chunk);
-            if (res)
-                luaL_errorL(thread, "failed to make HTTP GET request (%d)", res);
+            if (res) {
+                if (chunk.memory) free(chunk.memory);
+                throw std::runtime_error(std::string("failed to make HTTP GET request (").append(std::to_string(res)) += ')');
+            }
 
-            lua_pushlstring(thread, chunk.memory, chunk.size);
+            std::string body(chunk.memory ? chunk.memory : "", chunk.size);
             if (chunk.memory) free(chunk.memory);
 
-            return 1;
+            return [body = std::move(body)] (lua_State* thread) {
+                lua_pushlstring(thread, body.data(), body.size());
+                return 1;
+            };
         });
     }
 }; // namespace rbxInstance_DataModel_methods
 
 void rbxInstance_DataModel_init(lua_State* L) {
+    datamodel_class = rbxClass::class_map.at("DataModel").get();
     lua_newtable(L);
     lua_setfield(L, LUA_REGISTRYINDEX, TOCLOSEBINDS_KEY);
 
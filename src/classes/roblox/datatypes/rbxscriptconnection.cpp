@@ -1,4 +1,5 @@
 #include "classes/roblox/datatypes/rbxscriptconnection.hpp"
+#include "classes/roblox/datatypes/rbxscriptsignal.hpp"
 #include "common.hpp"
 
 #include "lapi.h"
@@ -7,62 +8,30 @@
 
 namespace frostbyte {
 
+uint64_t rbxScriptConnection::next_serial = 0;
+
 void rbxScriptConnection::destroy(lua_State* L) {
     if (!alive)
         return;
 
     lua_getfield(L, LUA_REGISTRYINDEX, RBXSCRIPTCONNECTION_METHODLOOKUP);
-
-    lua_rawgeti(L, -1, function_index);
-    lua_pushvalue(L, -1);
-    lua_rawget(L, -3);
-    double n = luaL_checknumber(L, -1);
-    lua_pop(L, 1);
-    n--;
-    if (n) {
-        lua_pushnumber(L, n);
-        lua_rawset(L, -3);
-    } else {
-        lua_pushnil(L);
-        lua_rawset(L, -3);
-
-        lua_pushnil(L);
-        lua_rawseti(L, -2, function_index);
-    }
-    lua_pop(L, 1);
+    releaseFromLookup(L, function_index);
 
     alive = false;
+    if (signal)
+        detachRBXScriptConnection(L, signal, slot);
 }
 
 int pushNewRBXScriptConnection(lua_State* L, std::function<void()> pushValue) {
     rbxScriptConnection* connection = static_cast<rbxScriptConnection*>(lua_newuserdata(L, sizeof(rbxScriptConnection)));
     new(connection) rbxScriptConnection();
+    connection->serial = rbxScriptConnection::next_serial++;
 
     luaL_getmetatable(L, "RBXScriptConnection");
     lua_setmetatable(L, -2);
 
     lua_getfield(L, LUA_REGISTRYINDEX, RBXSCRIPTCONNECTION_METHODLOOKUP);
-    connection->function_index = addToLookup(L, pushValue, true);
-
-    lua_getfield(L, LUA_REGISTRYINDEX, RBXSCRIPTCONNECTION_METHODLOOKUP);
-
-    lua_insert(L, -2);
-    lua_pushvalue(L, -1);
-
-    lua_rawget(L, -3);
-    if (lua_isnil(L, -1)) {
-        lua_pop(L, 1);
-        lua_pushnumber(L, 1);
-        lua_rawset(L, -3);
-    } else {
-        // TODO: more efficient way of doing this?
-        double value = luaL_checknumber(L, -1) + 1;
-        lua_pop(L, 1);
-        lua_pushnumber(L, value);
-        lua_rawset(L, -3);
-    }
-
-    lua_pop(L, 1);
+    connection->function_index = addToLookup(L, pushValue);
 
     return 1;
 }
@@ -20,8 +20,11 @@ int pushNewRBXScriptSignal(lua_State* L, std::string name) {
     luaL_getmetatable(L, "RBXScriptSignal");
     lua_setmetatable(L, -2);
 
-    lua_pushvalue(L, -1);
+    // connection list; slot 0 holds the signal so it lives as long as the list
+    lua_pushlightuserdata(L, signal);
     lua_newtable(L);
+    lua_pushvalue(L, -3);
+    lua_rawseti(L, -2, 0);
     lua_rawset(L, -4);
 
     lua_remove(L, -2);
@@ -35,16 +38,76 @@ rbxScriptSignal* lua_checkrbxscriptsignal(lua_State* L, int narg) {
     return static_cast<rbxScriptSignal*>(ud);
 }
 
-void pushSignalConnectionList(lua_State* L, int narg) {
-    if (narg < 0 && narg > LUA_REGISTRYINDEX)
-        narg--;
-
+static void pushSignalConnectionList(lua_State* L, rbxScriptSignal* signal) {
     lua_getfield(L, LUA_REGISTRYINDEX, SIGNALCONNECTIONLISTLOOKUP);
-    lua_pushvalue(L, narg);
+    lua_pushlightuserdata(L, signal);
     lua_rawget(L, -2);
     lua_remove(L, -2);
 }
 
+// drops disconnected slots, moving live connections down in both lists
+static void compactConnections(lua_State* L, rbxScriptSignal* signal) {
+    auto& list = signal->connection_list;
+    if (signal->firing || list.size() == signal->listener_count)
+        return;
+
+    pushSignalConnectionList(L, signal);
+
+    size_t live = 0;
+    for (size_t slot = 0; slot < list.size(); slot++) {
+        rbxScriptConnection* connection = list[slot];
+        if (!connection)
+            continue;
+
+        if (slot != live) {
+            list[live] = connection;
+            connection->slot = live;
+
+            lua_rawgeti(L, -1, slot + 1);
+            lua_rawseti(L, -2, live + 1);
+        }
+        live++;
+    }
+
+    for (size_t slot = live; slot < list.size(); slot++) {
+        lua_pushnil(L);
+        lua_rawseti(L, -2, slot + 1);
+    }
+    list.resize(live);
+
+    lua_pop(L, 1);
+}
+
+// connection at idx joins signal's list
+static void attachConnection(lua_State* L, rbxScriptSignal* signal, int idx) {
+    idx = lua_absindex(L, idx);
+
+    // signals that churn without being fired would otherwise only grow
+    if (signal->connection_list.size() >= 2 * signal->listener_count + 8)
+        compactConnections(L, signal);
+
+    rbxScriptConnection* connection = lua_checkrbxscriptconnection(L, idx);
+    connection->signal = signal;
+    connection->slot = signal->connection_list.size();
+    signal->connection_list.push_back(connection);
+    signal->listener_count++;
+
+    pushSignalConnectionList(L, signal);
+    lua_pushvalue(L, idx);
+    lua_rawseti(L, -2, connection->slot + 1);
+    lua_pop(L, 1);
+}
+
+void detachRBXScriptConnection(lua_State* L, rbxScriptSignal* signal, size_t slot) {
+    signal->connection_list[slot] = nullptr;
+    signal->listener_count--;
+
+    pushSignalConnectionList(L, signal);
+    lua_pushnil(L);
+    lua_rawseti(L, -2, slot + 1);
+    lua_pop(L, 1);
+}
+
 static int wait_proxy(lua_State* L) {
     const int thread_index = lua_upvalueindex(1);
     const int connection_index = lua_upvalueindex(2);
@@ -64,31 +127,23 @@ static int wait_proxy(lua_State* L) {
 }
 namespace rbxScriptSignal_methods {
     static int connect(lua_State* L) {
-        lua_checkrbxscriptsignal(L, 1);
+        rbxScriptSignal* signal = lua_checkrbxscriptsignal(L, 1);
         luaL_checktype(L, 2, LUA_TFUNCTION);
 
         pushNewRBXScriptConnection(L, 2);
-
-        pushSignalConnectionList(L, 1);
-        lua_pushvalue(L, -2);
-
-        lua_rawseti(L, -2, lua_objlen(L, -2) + 1);
-        lua_pop(L, 1);
+        attachConnection(L, signal, -1);
 
         return 1;
     }
     static int wait(lua_State* L) {
-        lua_checkrbxscriptsignal(L, 1);
-
-        pushSignalConnectionList(L, 1);
+        rbxScriptSignal* signal = lua_checkrbxscriptsignal(L, 1);
 
         pushNewRBXScriptConnection(L, [&L]() {
             lua_pushthread(L);
             lua_pushvalue(L, -3); // connection
             lua_pushcclosure(L, wait_proxy, "wait_proxy", 2);
         });
-
-        lua_rawseti(L, -2, lua_objlen(L, -2) + 1);
+        attachConnection(L, signal, -1);
         lua_pop(L, 1);
 
         return TaskScheduler::yieldThread(L);
@@ -142,38 +197,39 @@ static int rbxScriptSignal__namecall(lua_State* L) {
 }
 
 int fireRBXScriptSignalWithFilter(lua_State* L) {
-    lua_checkrbxscriptsignal(L, 1);
+    rbxScriptSignal* signal = lua_checkrbxscriptsignal(L, 1);
+    if (signal->listener_count == 0)
+        return 0;
     bool use_filter = !lua_isnil(L, 2);
     if (use_filter)
         luaL_checktype(L, 2, LUA_TFUNCTION);
 
     int arg_count = lua_gettop(L) - 2;
 
-    pushFunctionFromLookup(L, fr_task_spawn, "spawn");
+    lua_getfield(L, LUA_REGISTRYINDEX, RBXSCRIPTCONNECTION_METHODLOOKUP);
+    const int method_lookup_index = lua_gettop(L);
 
-    pushSignalConnectionList(L, 1);
-    lua_remove(L, 1);
+    // handlers can connect and disconnect while we fire; new connections wait for the next fire
+    // and disconnected slots stay in place until the outermost fire compacts them
+    struct FiringGuard {
+        rbxScriptSignal* signal;
+        FiringGuard(rbxScriptSignal* signal) : signal(signal) { signal->firing++; }
+        ~FiringGuard() { signal->firing--; }
+    };
 
-    lua_pushnil(L);
-    while (lua_next(L, -2) != 0) {
-        lua_pushvalue(L, -4); // task.spawn
-        lua_pushvalue(L, -2); // connection
+    {
+    FiringGuard guard(signal);
 
-        rbxScriptConnection* connection = lua_checkrbxscriptconnection(L, -1);
-        if (!connection->alive) {
-            lua_pop(L, 3);
+    const size_t count = signal->connection_list.size();
+    for (size_t slot = 0; slot < count; slot++) {
+        rbxScriptConnection* connection = signal->connection_list[slot];
+        if (!connection || !connection->alive)
             continue;
-        }
 
-        int function_index = connection->function_index;
-        lua_remove(L, -1);
-
-        lua_getfield(L, LUA_REGISTRYINDEX, RBXSCRIPTCONNECTION_METHODLOOKUP);
-        lua_rawgeti(L, -1, function_index); // function
-        lua_remove(L, -2);
+        lua_rawgeti(L, method_lookup_index, connection->function_index); // function
 
         if (use_filter) {
-            lua_pushvalue(L, 1); // filter
+            lua_pushvalue(L, 2); // filter
             lua_pushvalue(L, -2); // function
             lua_call(L, 1, 1);
 
@@ -181,18 +237,19 @@ int fireRBXScriptSignalWithFilter(lua_State* L) {
             lua_pop(L, 1);
 
             if (skip) {
-                lua_pop(L, 3);
+                lua_pop(L, 1);
                 continue;
             }
         }
 
         for (int i = 0; i < arg_count; i++)
-            lua_pushvalue(L, 2 + i);
-
-        lua_call(L, arg_count + 1, 0);
+            lua_pushvalue(L, 3 + i);
 
-        lua_pop(L, 1);
+        TaskScheduler::spawnHandler(L, arg_count);
     }
+    }
+
+    compactConnections(L, signal);
 
     return 0;
 }
@@ -204,18 +261,13 @@ int fireRBXScriptSignal(lua_State* L) {
 }
 
 int disconnectAllRBXScriptSignal(lua_State *L) {
-    lua_checkrbxscriptsignal(L, 1);
-
-    pushSignalConnectionList(L, 1);
-    lua_remove(L, 1);
+    rbxScriptSignal* signal = lua_checkrbxscriptsignal(L, 1);
 
-    lua_pushnil(L);
-    while (lua_next(L, -2) != 0) {
-        rbxScriptConnection* connection = lua_checkrbxscriptconnection(L, -1);
-        connection->destroy(L);
+    for (size_t slot = 0; slot < signal->connection_list.size(); slot++)
+        if (rbxScriptConnection* connection = signal->connection_list[slot])
+            connection->destroy(L);
 
-        lua_pop(L, 1);
-    }
+    compactConnections(L, signal);
 
     return 0;
 }
@@ -4,8 +4,11 @@ namespace frostbyte {
 
 std::map<rbxInstance*, bool> auto_button_color_map;
 
+static rbxClass* guibutton_class; // resolved in rbxInstance_GuiButton_init
+
 void rbxInstance_GuiButton_init() {
     auto& this_class = rbxClass::class_map["GuiButton"];
+    guibutton_class = this_class.get();
 
     this_class->constructor = [](lua_State* L, std::shared_ptr<rbxInstance> instance) {
         setInstanceValue(instance, L, "AutoButtonColor", true, true);
@@ -18,7 +21,7 @@ void rbxInstance_GuiButton_init() {
 }
 
 bool checkAutoButtonColor(std::shared_ptr<rbxInstance> instance) {
-    if (!instance->isA("GuiButton"))
+    if (!instance->isA(guibutton_class))
         return false;
     if (!getInstanceValue<bool>(instance, "AutoButtonColor"))
         return false;
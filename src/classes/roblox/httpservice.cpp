@@ -9,9 +9,11 @@ namespace frostbyte {
 
 UUIDv4::UUIDGenerator<std::mt19937_64> uuid_generator;
 
+static rbxClass* httpservice_class; // resolved in rbxInstance_HttpService_init
+
 namespace rbxInstance_HttpService_methods {
     static int generateGUID(lua_State* L) {
-        lua_checkinstance(L, 1, "HttpService");
+        lua_checkinstance(L, 1, httpservice_class);
 
         const bool wrap = luaL_optboolean(L, 2, true);
 
@@ -29,6 +31,7 @@ namespace rbxInstance_HttpService_methods {
 }; // namespace rbxInstance_HttpService_methods
 
 void rbxInstance_HttpService_init() {
+    httpservice_class = rbxClass::class_map.at("HttpService").get();
     rbxClass::class_map["HttpService"]->methods["GenerateGUID"].func = rbxInstance_HttpService_methods::generateGUID;
 }
 
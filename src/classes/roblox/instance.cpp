@@ -25,6 +25,7 @@
 #include "common.hpp"
 
 #include "console.hpp"
+#include "memberatoms.hpp"
 #include "taskscheduler.hpp"
 #include "ui/instanceexplorer.hpp"
 
@@ -34,11 +35,12 @@
 #include "lstate.h"
 
 #include <algorithm>
-#include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <map>
 #include <memory>
+#include <set>
 #include <variant>
 
 namespace frostbyte {
@@ -46,9 +48,139 @@ namespace frostbyte {
 std::map<std::string, std::shared_ptr<rbxClass>> rbxClass::class_map;
 std::vector<std::string> rbxClass::valid_class_names;
 std::vector<std::string> rbxClass::valid_services;
+size_t rbxClass::class_count = 0;
+std::vector<rbxClass*> rbxClass::class_by_atom;
 
 
+void rbxClass::finalize() {
+    if (finalized)
+        return;
+
+    if (superclass) {
+        superclass->finalize();
+        slots = superclass->slots;
+        slot_map = superclass->slot_map;
+        default_values = superclass->default_values;
+        all_events = superclass->all_events;
+        ancestry = superclass->ancestry;
+    }
+
+    id = class_count++;
+    ancestry.resize(id + 1, false);
+    ancestry[id] = true;
+
+    const int16_t atom = MemberAtoms::intern(name);
+    if (static_cast<size_t>(atom) >= class_by_atom.size())
+        class_by_atom.resize(atom + 1, nullptr);
+    class_by_atom[atom] = this;
+
+    for (auto& event : events)
+        if (std::find(all_events.begin(), all_events.end(), event) == all_events.end())
+            all_events.push_back(event);
+
+    for (auto& [property_name, property] : properties) {
+        property->name = property_name;
+
+        auto it = slot_map.find(property_name);
+        if (it == slot_map.end()) {
+            property->slot = slots.size();
+            slot_map.emplace(property_name, property->slot);
+            slots.push_back(property);
+            default_values.push_back(property->default_value.value);
+        } else {
+            // redefined in this class; keep the inherited slot
+            property->slot = it->second;
+            slots[property->slot] = property;
+            default_values[property->slot] = property->default_value.value;
+        }
+    }
+
+    finalized = true;
+}
+std::optional<size_t> rbxClass::findSlot(const char* name) {
+    finalize();
+
+    auto it = slot_map.find(name);
+    if (it == slot_map.end())
+        return std::nullopt;
+    return it->second;
+}
+rbxClass* rbxClass::find(const char* name, int atom) {
+    if (atom >= 0)
+        return static_cast<size_t>(atom) < class_by_atom.size() ? class_by_atom[atom] : nullptr;
+
+    auto it = class_map.find(name);
+    if (it == class_map.end())
+        return nullptr;
+    return it->second.get();
+}
+size_t rbxClass::getSlot(const char* name) {
+    auto slot = findSlot(name);
+    if (!slot)
+        throw std::out_of_range(std::string("'").append(name).append("' is not a property of ").append(this->name));
+    return *slot;
+}
+
+void rbxClass::buildMembers() {
+    finalize();
+
+    auto setMember = [this](const std::string& name, rbxMember member) {
+        const int16_t atom = MemberAtoms::intern(name);
+        if (static_cast<size_t>(atom) >= member_index.size())
+            member_index.resize(atom + 1, 0);
+
+        auto& index = member_index[atom];
+        if (!index) {
+            member_list.push_back(member);
+            index = member_list.size();
+        } else if (member.kind >= member_list[index - 1].kind)
+            member_list[index - 1] = member;
+    };
+
+    // root class first so subclasses override what they inherit
+    std::vector<rbxClass*> chain;
+    for (rbxClass* c = this; c; c = c->superclass.get())
+        chain.push_back(c);
+
+    for (size_t i = 0; i < all_events.size(); i++)
+        setMember(all_events[i], { .kind = rbxMember::Event, .slot = i });
+
+    for (auto it = chain.rbegin(); it != chain.rend(); it++)
+        for (auto& [method_name, method] : (*it)->methods)
+            setMember(method_name, { .kind = rbxMember::Method, .method = &method });
+
+    for (auto& property : slots) {
+        const size_t value_slot = property->route ? getSlot(property->route->c_str()) : property->slot;
+        setMember(property->name, { .kind = rbxMember::Property, .slot = property->slot, .value_slot = value_slot });
+    }
+
+    for (auto& member : member_list) {
+        if (member.kind != rbxMember::Method || !member.method->route)
+            continue;
+
+        const int16_t atom = MemberAtoms::intern(*member.method->route);
+        if (static_cast<size_t>(atom) >= member_index.size() || !member_index[atom])
+            continue;
+
+        auto& target = member_list[member_index[atom] - 1];
+        if (target.kind == rbxMember::Method)
+            member.method = target.method;
+    }
+}
+const rbxMember* rbxClass::findMember(int atom) {
+    std::call_once(members_built, [this] { buildMembers(); });
+
+    if (atom < 0 || static_cast<size_t>(atom) >= member_index.size())
+        return nullptr;
+
+    const uint16_t index = member_index[atom];
+    return index ? &member_list[index - 1] : nullptr;
+}
+
 std::shared_ptr<rbxProperty> rbxClass::newInternalProperty(const char* name, TypeCategory type_category, rbxValue default_value) {
+    // slots are fixed once a class has been finalized (its instances would have mismatched value vectors)
+    assert(!finalized);
+
     std::shared_ptr<rbxProperty> property = std::make_shared<rbxProperty>();
 
     property->internal = true;
@@ -65,6 +197,14 @@ std::shared_ptr<rbxProperty> rbxClass::newInternalProperty(const char* name, Typ
 std::vector<std::weak_ptr<rbxInstance>> rbxInstance::instance_list;
 std::shared_mutex rbxInstance::instance_list_mutex;
 
+size_t rbxInstance::archivable_slot;
+size_t rbxInstance::name_slot;
+size_t rbxInstance::class_name_slot;
+size_t rbxInstance::parent_slot;
+size_t rbxInstance::changed_event;
+rbxInstance::SignalBehavior rbxInstance::signal_behavior = rbxInstance::SignalBehavior::Immediate;
+size_t rbxInstance::deferred_fired_count = 0;
+
 rbxInstance::rbxInstance(std::shared_ptr<rbxClass> _class) : _class(_class) {}
 
 // lua_State* rbxInstance::destructorL = nullptr;
@@ -101,40 +241,155 @@ rbxInstance::~rbxInstance() {
 }
 
 bool rbxInstance::isA(rbxClass* target_class) {
-    rbxClass* c = _class.get();
-    while (c) {
-        if (c == target_class)
-            return true;
-        c = c->superclass.get();
-    }
-    return false;
+    target_class->finalize();
+
+    auto& ancestry = _class->ancestry;
+    return target_class->id < ancestry.size() && ancestry[target_class->id];
 }
 bool rbxInstance::isA(const char* class_name) {
     return isA(rbxClass::class_map.at(class_name).get());
 }
 
-int rbxInstance::pushEvent(lua_State* L, const char* name) {
+// pushes the signal called name from this instance's signallookup table, creating the table and the signal if needed
+static rbxScriptSignal* pushSignal(lua_State* L, rbxInstance* instance, const std::string& name, rbxScriptSignal* existing) {
     lua_getfield(L, LUA_REGISTRYINDEX, SIGNALLOOKUP);
-    lua_pushlightuserdata(L, this);
-    lua_rawget(L, -2);
-    lua_pushstring(L, name);
+    lua_pushlightuserdata(L, instance);
     lua_rawget(L, -2);
 
-    assert(!lua_isnil(L, -1));
+    if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushlightuserdata(L, instance);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, -4);
+    }
+
+    if (existing) {
+        lua_rawgetfield(L, -1, name.c_str());
+        assert(lua_touserdata(L, -1) == existing);
+    } else {
+        pushNewRBXScriptSignal(L, name);
+        lua_pushvalue(L, -1);
+        lua_rawsetfield(L, -3, name.c_str());
+        existing = static_cast<rbxScriptSignal*>(lua_touserdata(L, -1));
+    }
 
-    lua_remove(L, -2); // remove signallookup
     lua_remove(L, -2); // remove signallookup table
+    lua_remove(L, -2); // remove signallookup
+    return existing;
+}
+
+int rbxInstance::pushPropertySignal(lua_State* L, size_t slot) {
+    if (property_signals.size() <= slot)
+        property_signals.resize(_class->slots.size(), nullptr);
+
+    property_signals[slot] = pushSignal(L, this, _class->slots[slot]->name, property_signals[slot]);
     return 1;
 }
+int rbxInstance::pushEventSignal(lua_State* L, size_t index) {
+    if (event_signals.size() <= index)
+        event_signals.resize(_class->all_events.size(), nullptr);
+
+    event_signals[index] = pushSignal(L, this, _class->all_events[index], event_signals[index]);
+    return 1;
+}
+rbxScriptSignal* rbxInstance::getPropertySignal(size_t slot) {
+    return slot < property_signals.size() ? property_signals[slot] : nullptr;
+}
+rbxScriptSignal* rbxInstance::getEventSignal(size_t index) {
+    return index < event_signals.size() ? event_signals[index] : nullptr;
+}
+
+int rbxInstance::pushEvent(lua_State* L, const char* name) {
+    const rbxMember* member = _class->findMember(MemberAtoms::find(name, strlen(name)));
+    assert(member && member->kind != rbxMember::Method);
+
+    if (member->kind == rbxMember::Event)
+        return pushEventSignal(L, member->slot);
+    return pushPropertySignal(L, member->slot);
+}
+uint8_t rbxInstance::getPropertyTags(size_t slot) {
+    if (overlay) {
+        auto it = overlay->property_tags.find(slot);
+        if (it != overlay->property_tags.end())
+            return it->second;
+    }
+    return _class->slots[slot]->tags;
+}
+void rbxInstance::setPropertyTags(size_t slot, uint8_t tags) {
+    if (!overlay)
+        overlay = std::make_unique<MemberOverlay>();
+    overlay->property_tags[slot] = tags;
+}
+
+// deferred changes in the order they were first reported; a property written many times before a flush is only queued once
+struct DeferredChange {
+    std::weak_ptr<rbxInstance> instance;
+    size_t slot;
+};
+struct DeferredChangeKeyLess {
+    bool operator()(const std::pair<std::weak_ptr<rbxInstance>, size_t>& a, const std::pair<std::weak_ptr<rbxInstance>, size_t>& b) const {
+        if (a.first.owner_before(b.first))
+            return true;
+        if (b.first.owner_before(a.first))
+            return false;
+        return a.second < b.second;
+    }
+};
+static std::vector<DeferredChange> deferred_changes;
+static std::set<std::pair<std::weak_ptr<rbxInstance>, size_t>, DeferredChangeKeyLess> deferred_change_keys;
+
+static void fireChanged(lua_State* L, rbxInstance* instance, size_t slot) {
+    rbxScriptSignal* changed = instance->getEventSignal(rbxInstance::changed_event);
+    rbxScriptSignal* property_changed = instance->getPropertySignal(slot);
+
+    if (changed && changed->listener_count) {
+        pushFunctionFromLookup(L, fireRBXScriptSignal);
+        instance->pushEventSignal(L, rbxInstance::changed_event);
+        lua_pushstring(L, instance->_class->slots[slot]->name.c_str());
+        lua_call(L, 2, 0);
+    }
+
+    if (property_changed && property_changed->listener_count) {
+        pushFunctionFromLookup(L, fireRBXScriptSignal);
+        instance->pushPropertySignal(L, slot);
+        lua_call(L, 1, 0);
+    }
+}
+
+// signals that were never created or have nothing connected are skipped without touching the Lua stack
+void rbxInstance::reportChanged(lua_State* L, size_t slot) {
+    rbxScriptSignal* changed = getEventSignal(changed_event);
+    rbxScriptSignal* property_changed = getPropertySignal(slot);
+
+    if (!(changed && changed->listener_count) && !(property_changed && property_changed->listener_count))
+        return;
+
+    if (signal_behavior == SignalBehavior::Deferred) {
+        std::weak_ptr<rbxInstance> weak = weak_from_this();
+        if (deferred_change_keys.emplace(weak, slot).second)
+            deferred_changes.push_back({ std::move(weak), slot });
+        return;
+    }
+
+    fireChanged(L, this, slot);
+}
 void rbxInstance::reportChanged(lua_State* L, const char* property) {
-    pushFunctionFromLookup(L, fireRBXScriptSignal);
-    pushEvent(L, "Changed");
-    lua_pushstring(L, property);
-    lua_call(L, 2, 0);
-
-    pushFunctionFromLookup(L, fireRBXScriptSignal);
-    pushEvent(L, property);
-    lua_call(L, 1, 0);
+    reportChanged(L, _class->getSlot(property));
+}
+void rbxInstance::flushDeferredChanges(lua_State* L) {
+    for (int round = 0; round < max_deferred_rounds && !deferred_changes.empty(); round++) {
+        // handlers may report more changes; those go into the next round
+        std::vector<DeferredChange> changes;
+        changes.swap(deferred_changes);
+        deferred_change_keys.clear();
+
+        for (auto& change : changes)
+            if (std::shared_ptr<rbxInstance> instance = change.instance.lock()) {
+                fireChanged(L, instance.get(), change.slot);
+                deferred_fired_count++;
+            }
+    }
 }
 
 void clearAllInstanceChildren(lua_State* L, std::shared_ptr<rbxInstance> instance) {
@@ -145,6 +400,7 @@ void clearAllInstanceChildren(lua_State* L, std::shared_ptr<rbxInstance> instanc
         destroyInstance(L, children[i], true);
 
     children.clear();
+    instance->children_by_name.clear();
 }
 void destroyInstance(lua_State* L, std::shared_ptr<rbxInstance> instance, bool dont_remove_from_old_parent_children) {
     std::lock_guard destroyed_lock(instance->destroyed_mutex);
@@ -153,19 +409,19 @@ void destroyInstance(lua_State* L, std::shared_ptr<rbxInstance> instance, bool d
 
     clearAllInstanceChildren(L, instance);
 
-    for (auto& event : instance->events) {
+    for (size_t i = 0; i < instance->event_signals.size(); i++) {
+        if (!instance->event_signals[i])
+            continue;
         pushFunctionFromLookup(L, disconnectAllRBXScriptSignal);
-        instance->pushEvent(L, event.c_str());
+        instance->pushEventSignal(L, i);
         lua_call(L, 1, 0);
     }
-    rbxClass* c = instance->_class.get();
-    while (c) {
-        for (auto& property : c->properties) {
-            pushFunctionFromLookup(L, disconnectAllRBXScriptSignal);
-            instance->pushEvent(L, property.first.c_str());
-            lua_call(L, 1, 0);
-        }
-        c = c->superclass.get();
+    for (size_t slot = 0; slot < instance->property_signals.size(); slot++) {
+        if (!instance->property_signals[slot])
+            continue;
+        pushFunctionFromLookup(L, disconnectAllRBXScriptSignal);
+        instance->pushPropertySignal(L, slot);
+        lua_call(L, 1, 0);
     }
 
     setInstanceParent(L, instance, nullptr, dont_remove_from_old_parent_children);
@@ -181,12 +437,34 @@ void destroyInstance(lua_State* L, std::shared_ptr<rbxInstance> instance, bool d
     lua_pop(L, 1);
 }
 std::shared_ptr<rbxInstance> rbxInstance::findFirstChild(std::string name) {
-    std::lock_guard children_lock(children_mutex);
+    std::shared_lock children_lock(children_mutex);
 
-    for (size_t i = 0; i < children.size(); i++)
-        if (getInstanceValue<std::string>(children[i], PROP_INSTANCE_NAME) == name)
-            return children[i];
-    return nullptr;
+    auto it = children_by_name.lower_bound({ name, 0 });
+    if (it == children_by_name.end() || it->first.first != name)
+        return nullptr;
+    return it->second;
+}
+void rbxInstance::wakeChildWaiters(const std::string& name, std::shared_ptr<rbxInstance> child) {
+    auto [begin, end] = child_waiters.equal_range(name);
+    for (auto it = begin; it != end; it++) {
+        lua_pushinstance(it->second.thread, child);
+        TaskScheduler::wakeThread(it->second.thread, 1);
+        lua_unref(it->second.thread, it->second.ref);
+    }
+    child_waiters.erase(begin, end);
+}
+void renameInstanceChild(std::shared_ptr<rbxInstance> parent, std::shared_ptr<rbxInstance> child, const std::string& old_name, const std::string& new_name) {
+    std::lock_guard children_lock(parent->children_mutex);
+
+    auto node = parent->children_by_name.extract({ old_name, child->child_order });
+    if (!node)
+        return;
+
+    node.key().first = new_name;
+    parent->children_by_name.insert(std::move(node));
+
+    if (!parent->child_waiters.empty())
+        parent->wakeChildWaiters(new_name, child);
 }
 
 void addInstanceToDescendantsList(std::vector<std::shared_ptr<rbxInstance>>& descendants, std::shared_ptr<rbxInstance> instance, bool skip_instance = false) {
@@ -212,7 +490,7 @@ std::vector<std::shared_ptr<rbxInstance>>getDescendants(std::shared_ptr<rbxInsta
 bool isDescendantOf(std::shared_ptr<rbxInstance> instance, std::shared_ptr<rbxInstance> other) {
     assert(other);
 
-    auto parent = getInstanceValue<std::shared_ptr<rbxInstance>>(instance, PROP_INSTANCE_PARENT);
+    auto parent = getInstanceValue<std::shared_ptr<rbxInstance>>(instance, rbxInstance::parent_slot);
     if (!parent)
         return false;
 
@@ -220,15 +498,20 @@ bool isDescendantOf(std::shared_ptr<rbxInstance> instance, std::shared_ptr<rbxIn
         if (parent == other)
             return true;
 
-        parent = getInstanceValue<std::shared_ptr<rbxInstance>>(parent, PROP_INSTANCE_PARENT);
+        parent = getInstanceValue<std::shared_ptr<rbxInstance>>(parent, rbxInstance::parent_slot);
     } while (parent);
 
     return false;
 }
 
-rbxValueVariant& getInstanceValueVariant(std::shared_ptr<rbxInstance> instance, const char* name) {
+rbxValueVariant& getInstanceValueVariant(std::shared_ptr<rbxInstance> instance, size_t slot) {
+    assert(slot < instance->_class->slots.size()); // see setInstanceValue
+
     std::lock_guard lock(instance->values_mutex);
-    return instance->values.at(name).value;
+    return instance->values.at(slot);
+}
+rbxValueVariant& getInstanceValueVariant(std::shared_ptr<rbxInstance> instance, const char* name) {
+    return getInstanceValueVariant(instance, instance->_class->getSlot(name));
 }
 
 // TODO: we should probably use this in Instance __index if we can
@@ -296,9 +579,9 @@ rbxValueVariant luaValueToValueVariant(lua_State* L, int idx, rbxValueVariant& r
         assert(!"UNHANDLED ALTERNATIVE FOR DATATYPE VALUE");
 }
 
-void setInstanceValueVariant(std::shared_ptr<rbxInstance> instance, lua_State* L, const char* name, rbxValueVariant value, bool dont_report_changed) {
+void setInstanceValueVariant(std::shared_ptr<rbxInstance> instance, lua_State* L, size_t slot, rbxValueVariant value, bool dont_report_changed) {
     #define handleType(type) if (std::holds_alternative<type>(value))                           \
-        setInstanceValue<type>(instance, L, name, std::get<type>(value), dont_report_changed);  \
+        setInstanceValue<type>(instance, L, slot, std::get<type>(value), dont_report_changed);  \
 
     handleType(bool)
     else handleType(int32_t)
@@ -320,19 +603,22 @@ void setInstanceValueVariant(std::shared_ptr<rbxInstance> instance, lua_State* L
     else handleType(NumberSequence)
     else handleType(Rect)
     else handleType(UDim)
-    else handleType(UDim)
+    else handleType(UDim2)
     else handleType(Vector2)
     else handleType(Vector3)
 
     #undef handleType
 }
+void setInstanceValueVariant(std::shared_ptr<rbxInstance> instance, lua_State* L, const char* name, rbxValueVariant value, bool dont_report_changed) {
+    setInstanceValueVariant(instance, L, instance->_class->getSlot(name), value, dont_report_changed);
+}
 
-std::shared_ptr<rbxInstance>& lua_checkinstance(lua_State* L, int narg, const char* class_name) {
+std::shared_ptr<rbxInstance>& lua_checkinstance(lua_State* L, int narg, rbxClass* target_class) {
     void* ud = luaL_checkudatareal(L, narg, "Instance");
     SharedPtrObject* object = static_cast<SharedPtrObject*>(ud);
     auto instance = static_cast<std::shared_ptr<rbxInstance>*>(object->object);
 
-    if (class_name && !(*instance)->isA(class_name)) {
+    if (target_class && !(*instance)->isA(target_class)) {
         Closure* cl = L->ci > L->base_ci ? curr_func(L) : NULL;
         assert(cl);
         assert(cl->isC);
@@ -350,13 +636,19 @@ std::shared_ptr<rbxInstance>& lua_checkinstance(lua_State* L, int narg, const ch
 
     return *instance;
 }
-std::shared_ptr<rbxInstance> lua_optinstance(lua_State* L, int narg, const char* class_name) {
+std::shared_ptr<rbxInstance>& lua_checkinstance(lua_State* L, int narg, const char* class_name) {
+    return lua_checkinstance(L, narg, class_name ? rbxClass::class_map.at(class_name).get() : nullptr);
+}
+std::shared_ptr<rbxInstance> lua_optinstance(lua_State* L, int narg, rbxClass* target_class) {
     if (lua_isnoneornil(L, narg))
         return nullptr;
 
     luaL_argexpected(L, lua_isuserdata(L, narg), narg, "userdata or nil");
 
-    return lua_checkinstance(L, narg, class_name);
+    return lua_checkinstance(L, narg, target_class);
+}
+std::shared_ptr<rbxInstance> lua_optinstance(lua_State* L, int narg, const char* class_name) {
+    return lua_optinstance(L, narg, class_name ? rbxClass::class_map.at(class_name).get() : nullptr);
 }
 
 namespace rbxInstance_methods {
@@ -423,8 +715,8 @@ namespace rbxInstance_methods {
         std::shared_ptr<rbxInstance> inst = instance;
         do {
             result.insert(result.begin(), '.');
-            result.insert(0, getInstanceValue<std::string>(inst, PROP_INSTANCE_NAME));
-            inst = getInstanceValue<std::shared_ptr<rbxInstance>>(inst, PROP_INSTANCE_PARENT);
+            result.insert(0, getInstanceValue<std::string>(inst, rbxInstance::name_slot));
+            inst = getInstanceValue<std::shared_ptr<rbxInstance>>(inst, rbxInstance::parent_slot);
         } while (inst);
 
         size_t last = result.size() - 1;
@@ -438,24 +730,23 @@ namespace rbxInstance_methods {
         auto instance = lua_checkinstance(L, 1);
         const char* key = luaL_checkstring(L, 2);
 
-        if (instance->values.find(key) == instance->values.end())
+        auto slot = instance->_class->findSlot(key);
+        if (!slot)
             luaL_error(L, "%s is not a valid property name.", key);
 
-        auto value = &instance->values[key];
-        auto& property = value->property;
-        if (property->route)
-            value = &instance->values[*property->route];
-
-        if (property->tags & rbxProperty::NotScriptable)
+        if (instance->getPropertyTags(*slot) & rbxProperty::NotScriptable)
             luaL_error(L, "%s is not a scriptable property.", key);
 
-        return instance->pushEvent(L, key);
+        return instance->pushPropertySignal(L, *slot);
     }
     static int isA(lua_State* L) {
         auto instance = lua_checkinstance(L, 1);
-        const char* class_name = luaL_checkstring(L, 2);
+        luaL_checkstring(L, 2);
+        int atom;
+        const char* class_name = lua_tostringatom(L, 2, &atom);
 
-        lua_pushboolean(L, instance->isA(class_name));
+        rbxClass* target_class = rbxClass::find(class_name, atom);
+        lua_pushboolean(L, target_class && instance->isA(target_class));
         return 1;
     }
     static int isDescendantOf(lua_State* L) {
@@ -477,57 +768,73 @@ namespace rbxInstance_methods {
             return 1;
         }
 
-        return TaskScheduler::yieldForWork(L, [instance, name, timeout] (lua_State* thread) {
-            auto start = std::chrono::system_clock::now();
+        // setInstanceParent and renames wake the thread when the child shows up
+        lua_pushthread(L);
+        const int ref = lua_ref(L, -1);
+        lua_pop(L, 1);
+
+        {
+        std::lock_guard children_lock(instance->children_mutex);
+        instance->child_waiters.emplace(name, rbxInstance::ChildWaiter{ .thread = L, .ref = ref });
+        }
+
+        auto remove_waiter = [instance, name, L] {
+            std::lock_guard children_lock(instance->children_mutex);
 
-            auto child = instance->findFirstChild(name);
-            while (!child) {
-                if (std::chrono::duration<double>(std::chrono::system_clock::now() - start).count() >= timeout) {
-                    getTask(thread)->console->warningf("TODO this message lol; infinite yield possible while waiting for child \"%.*s\"", static_cast<int>(name.size()), name.c_str());
-                    return 0;
+            auto [begin, end] = instance->child_waiters.equal_range(name);
+            for (auto it = begin; it != end; it++)
+                if (it->second.thread == L) {
+                    lua_unref(L, it->second.ref);
+                    instance->child_waiters.erase(it);
+                    break;
                 }
-                child = instance->findFirstChild(name);
-            }
+        };
 
-            lua_pushinstance(thread, child);
-            return 1;
-        });
+        return TaskScheduler::yieldWithTimeout(L, timeout, [remove_waiter, name] (lua_State* thread) {
+            remove_waiter();
+
+            getTask(thread)->console->warningf("TODO this message lol; infinite yield possible while waiting for child \"%.*s\"", static_cast<int>(name.size()), name.c_str());
+            return 0;
+        }, remove_waiter); // a killed or canceled thread never wakes, so its entry and ref would otherwise stay until the child shows up
     }
 }; // namespace rbxInstance_methods
 
 int rbxInstance__tostring(lua_State* L) {
     std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1);
-    auto name = getInstanceValue<std::string>(instance, PROP_INSTANCE_NAME);
+    auto name = getInstanceValue<std::string>(instance, rbxInstance::name_slot);
     lua_pushlstring(L, name.c_str(), name.size());
     return 1;
 }
 
-int pushMethod(lua_State* L, std::shared_ptr<rbxInstance>& instance, std::string method_name) {
-    rbxMethod method = instance->methods[method_name];
-    if (method.route)
-        method = instance->methods[*method.route];
+int pushMethod(lua_State* L, const rbxMethod* method) {
+    assert(!method->route);
 
-    assert(!method.route);
-
-    if (method.func)
-        return pushFunctionFromLookup(L, method.func, method.name.c_str(), method.cont);
+    if (method->func)
+        return pushFunctionFromLookup(L, method->func, method->name.c_str(), method->cont);
     else
-        luaL_error(L, "INTERNAL ERROR: TODO implement '%s'", method.name.c_str());
+        luaL_error(L, "INTERNAL ERROR: TODO implement '%s'", method->name.c_str());
 
     return 0;
 }
 
+// a key only lacks an atom when its string was created before the name was interned
+static const rbxMember* findMemberForKey(std::shared_ptr<rbxInstance>& instance, const char* key, int atom) {
+    if (atom < 0)
+        atom = MemberAtoms::find(key, strlen(key));
+    return instance->_class->findMember(atom);
+}
+
 int rbxInstance__index(lua_State* L) {
     std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1);
-    const char* key = luaL_checkstring(L, 2);
-
-    auto class_name = getInstanceValue<std::string>(instance, PROP_INSTANCE_CLASS_NAME);
-    if (instance->values.find(key) == instance->values.end()) {
-        if (instance->methods.find(key) != instance->methods.end())
-            return pushMethod(L, instance, key);
-        if (std::find(instance->events.begin(), instance->events.end(), key) != instance->events.end())
-            return instance->pushEvent(L, key);
+    int atom;
+    const char* key = lua_tostringatom(L, 2, &atom);
+    if (!key) {
+        key = luaL_checkstring(L, 2);
+        atom = MemberAtoms::NO_ATOM;
+    }
 
+    const rbxMember* member = findMemberForKey(instance, key, atom);
+    if (!member) {
         auto child = instance->findFirstChild(key);
         if (child) {
             lua_pushinstance(L, child);
@@ -536,43 +843,47 @@ int rbxInstance__index(lua_State* L) {
         goto INVALID_MEMBER;
     }
 
+    if (member->kind == rbxMember::Method)
+        return pushMethod(L, member->method);
+    if (member->kind == rbxMember::Event)
+        return instance->pushEventSignal(L, member->slot);
+
     {
-    auto value = &instance->values[key];
-    auto property = value->property;
-    if (property->route)
-        value = &instance->values[*property->route];
+    auto& property = instance->_class->slots[member->slot];
+    const uint8_t tags = instance->getPropertyTags(member->slot);
 
     if (property->internal)
         goto INVALID_MEMBER;
 
-    if (property->tags & rbxProperty::NotScriptable)
+    if (tags & rbxProperty::NotScriptable)
         goto INVALID_MEMBER;
 
-    if (property->tags & rbxProperty::WriteOnly)
-        luaL_error(L, "'%s' is a write-only member of %s", key, class_name.c_str());
+    if (tags & rbxProperty::WriteOnly)
+        luaL_error(L, "'%s' is a write-only member of %s", key, instance->_class->name.c_str());
 
     std::lock_guard values_lock(instance->values_mutex);
+    auto& value = instance->values[member->value_slot];
 
-    if (std::holds_alternative<std::monostate>(value->value))
+    if (std::holds_alternative<std::monostate>(value))
         lua_pushnil(L);
     else {
         switch (property->type_category) {
             case Primitive:
-                if (std::holds_alternative<bool>(value->value))
-                    lua_pushboolean(L, std::get<bool>(value->value));
-                else if (std::holds_alternative<int32_t>(value->value))
-                    lua_pushinteger(L, std::get<int32_t>(value->value));
-                else if (std::holds_alternative<int64_t>(value->value))
-                    lua_pushinteger(L, std::get<int64_t>(value->value));
-                else if (std::holds_alternative<float>(value->value))
-                    lua_pushnumber(L, std::get<float>(value->value));
-                else if (std::holds_alternative<double>(value->value))
-                    lua_pushnumber(L, std::get<double>(value->value));
-                else if (std::holds_alternative<std::string>(value->value)) {
-                    std::string str = std::get<std::string>(value->value);
+                if (std::holds_alternative<bool>(value))
+                    lua_pushboolean(L, std::get<bool>(value));
+                else if (std::holds_alternative<int32_t>(value))
+                    lua_pushinteger(L, std::get<int32_t>(value));
+                else if (std::holds_alternative<int64_t>(value))
+                    lua_pushinteger(L, std::get<int64_t>(value));
+                else if (std::holds_alternative<float>(value))
+                    lua_pushnumber(L, std::get<float>(value));
+                else if (std::holds_alternative<double>(value))
+                    lua_pushnumber(L, std::get<double>(value));
+                else if (std::holds_alternative<std::string>(value)) {
+                    std::string str = std::get<std::string>(value);
                     lua_pushlstring(L, str.c_str(), str.size());
-                } else if (std::holds_alternative<rbxCallback>(value->value)) {
-                    // auto& wrapper = std::get<LuaFunctionWrapper>(value->value);
+                } else if (std::holds_alternative<rbxCallback>(value)) {
+                    // auto& wrapper = std::get<LuaFunctionWrapper>(value);
                     // if (wrapper.index == -1) {
                     //     lua_pushnil(L);
                     // } else {
@@ -581,44 +892,44 @@ int rbxInstance__index(lua_State* L) {
                     //     lua_remove(L, -2);
                     // }
 
-                    luaL_error(L, "%s is a callback member of %s; you can only set the callback value, get is not available", key, class_name.c_str());
+                    luaL_error(L, "%s is a callback member of %s; you can only set the callback value, get is not available", key, instance->_class->name.c_str());
                 } else
                     assert(!"UNHANDLED ALTERNATIVE FOR PROPERTY VALUE");
                 break;
             case DataType: {
-                if (std::holds_alternative<EnumItemWrapper>(value->value))
-                    assert(pushEnumItem(L, std::get<EnumItemWrapper>(value->value)) == 1);
-
-                else if (std::holds_alternative<Color>(value->value))
-                    assert(pushColor(L, std::get<Color>(value->value)) == 1);
-                else if (std::holds_alternative<TweenInfo>(value->value))
-                    assert(pushTweenInfo(L, std::get<TweenInfo>(value->value)) == 1);
-                else if (std::holds_alternative<ColorSequenceKeypoint>(value->value))
-                    assert(pushColorSequenceKeypoint(L, std::get<ColorSequenceKeypoint>(value->value)) == 1);
-                else if (std::holds_alternative<ColorSequence>(value->value))
-                    assert(pushColorSequence(L, std::get<ColorSequence>(value->value)) == 1);
-                else if (std::holds_alternative<NumberRange>(value->value))
-                    assert(pushNumberRange(L, std::get<NumberRange>(value->value)) == 1);
-                else if (std::holds_alternative<NumberSequenceKeypoint>(value->value))
-                    assert(pushNumberSequenceKeypoint(L, std::get<NumberSequenceKeypoint>(value->value)) == 1);
-                else if (std::holds_alternative<NumberSequence>(value->value))
-                    assert(pushNumberSequence(L, std::get<NumberSequence>(value->value)) == 1);
-                else if (std::holds_alternative<Rect>(value->value))
-                    assert(pushRect(L, std::get<Rect>(value->value)) == 1);
-                else if (std::holds_alternative<UDim>(value->value))
-                    assert(pushUDim(L, std::get<UDim>(value->value)) == 1);
-                else if (std::holds_alternative<UDim2>(value->value))
-                    assert(pushUDim2(L, std::get<UDim2>(value->value)) == 1);
-                else if (std::holds_alternative<Vector2>(value->value))
-                    assert(pushVector2(L, std::get<Vector2>(value->value)) == 1);
-                else if (std::holds_alternative<Vector3>(value->value))
-                    assert(pushVector3(L, std::get<Vector3>(value->value)) == 1);
+                if (std::holds_alternative<EnumItemWrapper>(value))
+                    assert(pushEnumItem(L, std::get<EnumItemWrapper>(value)) == 1);
+
+                else if (std::holds_alternative<Color>(value))
+                    assert(pushColor(L, std::get<Color>(value)) == 1);
+                else if (std::holds_alternative<TweenInfo>(value))
+                    assert(pushTweenInfo(L, std::get<TweenInfo>(value)) == 1);
+                else if (std::holds_alternative<ColorSequenceKeypoint>(value))
+                    assert(pushColorSequenceKeypoint(L, std::get<ColorSequenceKeypoint>(value)) == 1);
+                else if (std::holds_alternative<ColorSequence>(value))
+                    assert(pushColorSequence(L, std::get<ColorSequence>(value)) == 1);
+                else if (std::holds_alternative<NumberRange>(value))
+                    assert(pushNumberRange(L, std::get<NumberRange>(value)) == 1);
+                else if (std::holds_alternative<NumberSequenceKeypoint>(value))
+                    assert(pushNumberSequenceKeypoint(L, std::get<NumberSequenceKeypoint>(value)) == 1);
+                else if (std::holds_alternative<NumberSequence>(value))
+                    assert(pushNumberSequence(L, std::get<NumberSequence>(value)) == 1);
+                else if (std::holds_alternative<Rect>(value))
+                    assert(pushRect(L, std::get<Rect>(value)) == 1);
+                else if (std::holds_alternative<UDim>(value))
+                    assert(pushUDim(L, std::get<UDim>(value)) == 1);
+                else if (std::holds_alternative<UDim2>(value))
+                    assert(pushUDim2(L, std::get<UDim2>(value)) == 1);
+                else if (std::holds_alternative<Vector2>(value))
+                    assert(pushVector2(L, std::get<Vector2>(value)) == 1);
+                else if (std::holds_alternative<Vector3>(value))
+                    assert(pushVector3(L, std::get<Vector3>(value)) == 1);
                 else
                     assert("!UNHANDLED ALTERNATIVE FOR DATATYPE VALUE");
 
                 break;
             } case Instance:
-                lua_pushinstance(L, std::get<std::shared_ptr<rbxInstance>>(value->value));
+                lua_pushinstance(L, std::get<std::shared_ptr<rbxInstance>>(value));
                 break;
         }
     }
@@ -627,18 +938,19 @@ int rbxInstance__index(lua_State* L) {
     }
 
     INVALID_MEMBER:
-    auto name = getInstanceValue<std::string>(instance, PROP_INSTANCE_NAME);
+    auto name = getInstanceValue<std::string>(instance, rbxInstance::name_slot);
+    auto class_name = getInstanceValue<std::string>(instance, rbxInstance::class_name_slot);
     luaL_error(L, "%s is not a valid member of %s \"%s\"", key, class_name.c_str(), name.c_str());
 };
 
 const char* getOptionalInstanceName(std::shared_ptr<rbxInstance> instance) {
     if (!instance)
         return "NULL";
-    return getInstanceValue<std::string>(instance, PROP_INSTANCE_NAME).c_str();
+    return getInstanceValue<std::string>(instance, rbxInstance::name_slot).c_str();
 }
 
 void setInstanceParent(lua_State* L, std::shared_ptr<rbxInstance> instance, std::shared_ptr<rbxInstance> new_parent, bool dont_remove_from_old_parent_children, bool dont_set_value) {
-    std::shared_ptr<rbxInstance> old_parent = getInstanceValue<std::shared_ptr<rbxInstance>>(instance, PROP_INSTANCE_PARENT);
+    std::shared_ptr<rbxInstance> old_parent = getInstanceValue<std::shared_ptr<rbxInstance>>(instance, rbxInstance::parent_slot);
 
     std::shared_lock parent_locked_lock(instance->parent_locked_mutex);
     if (instance->parent_locked)
@@ -651,16 +963,23 @@ void setInstanceParent(lua_State* L, std::shared_ptr<rbxInstance> instance, std:
         std::lock_guard old_parent_children_lock(old_parent->children_mutex);
 
         old_parent->children.erase(std::find(old_parent->children.begin(), old_parent->children.end(), instance));
+        old_parent->children_by_name.erase({ getInstanceValue<std::string>(instance, rbxInstance::name_slot), instance->child_order });
     }
 
     if (new_parent) {
         std::lock_guard parent_children_lock(new_parent->children_mutex);
 
         new_parent->children.push_back(instance);
+        instance->child_order = new_parent->next_child_order++;
+        auto& name = getInstanceValue<std::string>(instance, rbxInstance::name_slot);
+        new_parent->children_by_name.emplace(std::pair(name, instance->child_order), instance);
+
+        if (!new_parent->child_waiters.empty())
+            new_parent->wakeChildWaiters(name, instance);
     }
 
     if (!dont_set_value)
-        std::get<std::shared_ptr<rbxInstance>>(instance->values[PROP_INSTANCE_PARENT].value) = new_parent;
+        std::get<std::shared_ptr<rbxInstance>>(instance->values[rbxInstance::parent_slot]) = new_parent;
 }
 
 static int fr_getinstances(lua_State* L) {
@@ -688,7 +1007,7 @@ std::vector<std::weak_ptr<rbxInstance>> getNilInstances() {
         auto child = rbxInstance::instance_list[i].lock();
         if (!child)
             continue;
-        if (getInstanceValue<std::shared_ptr<rbxInstance>>(child, PROP_INSTANCE_PARENT))
+        if (getInstanceValue<std::shared_ptr<rbxInstance>>(child, rbxInstance::parent_slot))
             continue;
 
         nil_instances.push_back(child);
@@ -716,73 +1035,79 @@ static int fr_getnilinstances(lua_State* L) {
 
 int rbxInstance__newindex(lua_State* L) {
     std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1);
-    const char* key = luaL_checkstring(L, 2);
+    int atom;
+    const char* key = lua_tostringatom(L, 2, &atom);
+    if (!key) {
+        key = luaL_checkstring(L, 2);
+        atom = MemberAtoms::NO_ATOM;
+    }
     luaL_checkany(L, 3);
 
-    auto class_name = getInstanceValue<std::string>(instance, PROP_INSTANCE_CLASS_NAME);
-    if (instance->values.find(key) == instance->values.end())
+    const rbxMember* member = findMemberForKey(instance, key, atom);
+    if (!member || member->kind != rbxMember::Property)
         goto INVALID_MEMBER;
 
     {
-    auto value = &instance->values[key];
-    auto property = value->property;
-    if (property->route)
-        value = &instance->values[*property->route];
+    auto& property = instance->_class->slots[member->slot];
+    const size_t value_slot = member->value_slot;
+    auto& value = instance->values[value_slot];
+
+    const uint8_t tags = instance->getPropertyTags(member->slot);
 
     if (property->internal)
         goto INVALID_MEMBER;
 
-    if (property->tags & rbxProperty::NotScriptable)
+    if (tags & rbxProperty::NotScriptable)
         goto INVALID_MEMBER;
 
-    if (property->tags & rbxProperty::ReadOnly)
+    if (tags & rbxProperty::ReadOnly)
         // luaL_error(L, "'%s' is a read-only member of %s", key, class_name.c_str());
         luaL_error(L, "Unable to assign property %s. Property is read only", key);
 
     switch (property->type_category) {
         case Primitive:
-            if (std::holds_alternative<bool>(value->value)) {
+            if (std::holds_alternative<bool>(value)) {
                 const bool new_value = lua_toboolean(L, 3);
-                setInstanceValue(instance, L, key, new_value);
-            } else if (std::holds_alternative<int32_t>(value->value)) {
+                setInstanceValue(instance, L, value_slot, new_value);
+            } else if (std::holds_alternative<int32_t>(value)) {
                 int isnum;
                 const int32_t new_value = lua_tointegerx(L, 3, &isnum);
                 if (!isnum)
                     getTask(L)->console->warningf("value of type %s cannot be converted to a number", luaL_typename(L, 3));
-                setInstanceValue(instance, L, key, new_value);
-            } else if (std::holds_alternative<int64_t>(value->value)) {
+                setInstanceValue(instance, L, value_slot, new_value);
+            } else if (std::holds_alternative<int64_t>(value)) {
                 int isnum;
                 const int64_t new_value = lua_tointegerx(L, 3, &isnum);
                 if (!isnum)
                     getTask(L)->console->warningf("value of type %s cannot be converted to a number", luaL_typename(L, 3));
-                setInstanceValue(instance, L, key, new_value);
-            } else if (std::holds_alternative<float>(value->value)) {
+                setInstanceValue(instance, L, value_slot, new_value);
+            } else if (std::holds_alternative<float>(value)) {
                 int isnum;
                 const float new_value = lua_tonumberx(L, 3, &isnum);
                 if (!isnum)
                     getTask(L)->console->warningf("value of type %s cannot be converted to a number", luaL_typename(L, 3));
-                setInstanceValue(instance, L, key, new_value);
-            } else if (std::holds_alternative<double>(value->value)) {
+                setInstanceValue(instance, L, value_slot, new_value);
+            } else if (std::holds_alternative<double>(value)) {
                 int isnum;
                 const double new_value = lua_tonumberx(L, 3, &isnum);
                 if (!isnum)
                     getTask(L)->console->warningf("value of type %s cannot be converted to a number", luaL_typename(L, 3));
-                setInstanceValue(instance, L, key, new_value);
-            } else if (std::holds_alternative<std::string>(value->value)) {
+                setInstanceValue(instance, L, value_slot, new_value);
+            } else if (std::holds_alternative<std::string>(value)) {
                 size_t l;
                 const char* str = luaL_tolstring(L, 3, &l);
                 if (str == NULL)
                     luaL_error(L, "Unable to assign property %s. string expected, got %s", key, luaL_typename(L, 3));
 
                 const std::string new_value = std::string(str, l);
-                setInstanceValue(instance, L, key, new_value);
-            } else if (std::holds_alternative<rbxCallback>(value->value)) {
+                setInstanceValue(instance, L, value_slot, new_value);
+            } else if (std::holds_alternative<rbxCallback>(value)) {
                 if (lua_isnil(L, 3))
                     goto SKIP;
 
                 // NOTE: Roblox does not do this! the value will be set to whatever type
                 luaL_checktype(L, 3, LUA_TFUNCTION);
-                auto& current = std::get<rbxCallback>(value->value);
+                auto& current = std::get<rbxCallback>(value);
 
                 lua_getfield(L, LUA_REGISTRYINDEX, METHODLOOKUP);
                 const int new_value = addToLookup(L, [&L] {
@@ -796,58 +1121,58 @@ int rbxInstance__newindex(lua_State* L) {
                 assert(!"UNHANDLED ALTERNATIVE FOR PROPERTY VALUE");
             break;
         case DataType:
-            if (std::holds_alternative<std::monostate>(value->value))
+            if (std::holds_alternative<std::monostate>(value))
                 // TODO: why did i create this branch lol....
                 ;
-            if (std::holds_alternative<EnumItemWrapper>(value->value)) {
-                const char* expected_enum = std::get<EnumItemWrapper>(value->value).enum_name.c_str();
+            if (std::holds_alternative<EnumItemWrapper>(value)) {
+                const char* expected_enum = std::get<EnumItemWrapper>(value).enum_name.c_str();
                 const std::string new_value = lua_checkenumitem(L, 3, expected_enum)->name;
-                setInstanceValue(instance, L, key, new_value);
+                setInstanceValue(instance, L, value_slot, new_value);
 
-            } else if (std::holds_alternative<Color>(value->value)) {
+            } else if (std::holds_alternative<Color>(value)) {
             // TODO: (for all of these types) use to* not check* and error "Unable to assign property %skey. %stype expected, got %stypename3"
                 const auto new_value = lua_checkcolor(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<TweenInfo>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<TweenInfo>(value)) {
                 const auto new_value = lua_checktweeninfo(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<ColorSequenceKeypoint>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<ColorSequenceKeypoint>(value)) {
                 const auto new_value = lua_checkcolorsequencekeypoint(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<ColorSequence>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<ColorSequence>(value)) {
                 const auto new_value = lua_checkcolorsequence(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<NumberRange>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<NumberRange>(value)) {
                 const auto new_value = lua_checknumberrange(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<NumberSequenceKeypoint>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<NumberSequenceKeypoint>(value)) {
                 const auto new_value = lua_checknumbersequencekeypoint(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<NumberSequence>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<NumberSequence>(value)) {
                 const auto new_value = lua_checknumbersequence(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<Rect>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<Rect>(value)) {
                 const auto new_value = lua_checkrect(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<UDim>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<UDim>(value)) {
                 const auto new_value = lua_checkudim(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<UDim2>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<UDim2>(value)) {
                 const auto new_value = lua_checkudim2(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<Vector2>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<Vector2>(value)) {
                 const auto new_value = lua_checkvector2(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
-            } else if (std::holds_alternative<Vector3>(value->value)) {
+                setInstanceValue(instance, L, value_slot, *new_value);
+            } else if (std::holds_alternative<Vector3>(value)) {
                 const auto new_value = lua_checkvector3(L, 3);
-                setInstanceValue(instance, L, key, *new_value);
+                setInstanceValue(instance, L, value_slot, *new_value);
             } else
                 assert(!"UNHANDLED ALTERNATIVE FOR DATATYPE VALUE");
 
             break;
         case Instance: {
             std::shared_ptr<rbxInstance> new_value = lua_optinstance(L, 3);
-            setInstanceValue(instance, L, key, new_value);
+            setInstanceValue(instance, L, value_slot, new_value);
             break;
         }
 
@@ -859,67 +1184,57 @@ int rbxInstance__newindex(lua_State* L) {
     return 0;
 
     INVALID_MEMBER:
-    auto name = getInstanceValue<std::string>(instance, PROP_INSTANCE_NAME);
+    auto name = getInstanceValue<std::string>(instance, rbxInstance::name_slot);
+    auto class_name = getInstanceValue<std::string>(instance, rbxInstance::class_name_slot);
     luaL_error(L, "%s is not a valid member of %s \"%s\"", key, class_name.c_str(), name.c_str());
 };
 int rbxInstance__namecall(lua_State* L) {
     std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1);
-    const char* namecall = lua_namecallatom(L, nullptr);
+    int atom;
+    const char* namecall = lua_namecallatom(L, &atom);
     if (!namecall)
         luaL_error(L, "no namecall method!");
-    std::string method_name = namecall;
 
-    if (instance->methods.find(method_name) == instance->methods.end()) {
-        auto name = getInstanceValue<std::string>(instance, PROP_INSTANCE_NAME);
-        auto class_name = getInstanceValue<std::string>(instance, PROP_INSTANCE_CLASS_NAME);
+    const rbxMember* member = findMemberForKey(instance, namecall, atom);
+    if (!member || member->kind != rbxMember::Method) {
+        auto name = getInstanceValue<std::string>(instance, rbxInstance::name_slot);
+        auto class_name = getInstanceValue<std::string>(instance, rbxInstance::class_name_slot);
         luaL_error(L, "%s is not a valid member of %s \"%s\"", namecall, class_name.c_str(), name.c_str());
     }
 
-    lua_CFunction func = instance->methods[method_name].func;
+    lua_CFunction func = member->method->func;
     if (func)
-        return instance->methods[method_name].func(L);
+        return func(L);
     else
-        luaL_error(L, "INTERNAL ERROR: TODO implement '%s'", method_name.c_str());
+        luaL_error(L, "INTERNAL ERROR: TODO implement '%s'", member->method->name.c_str());
 }
 
 std::shared_ptr<rbxInstance> newInstance(lua_State* L, const char* class_name, std::shared_ptr<rbxInstance> parent) {
     std::shared_ptr<rbxClass> _class = rbxClass::class_map[class_name];
-    std::shared_ptr<rbxInstance> instance = std::make_shared<rbxInstance>(_class);
+    _class->finalize();
 
-    lua_newtable(L);
+    std::shared_ptr<rbxInstance> instance = std::make_shared<rbxInstance>(_class);
+    instance->values = _class->default_values;
 
+    // signals are created on first use; drop any table left behind by an instance that lived at this address
     lua_getfield(L, LUA_REGISTRYINDEX, SIGNALLOOKUP);
     lua_pushlightuserdata(L, instance.get());
-    lua_pushvalue(L, -3);
+    lua_pushnil(L);
     lua_rawset(L, -3);
-
     lua_pop(L, 1);
 
     rbxClass* c = _class.get();
     while (c) {
-        for (auto& property : c->properties) {
-            instance->values[property.first] = property.second->default_value;
-            // for GetPropertyChangedSignal
-            pushNewRBXScriptSignal(L, property.first);
-            lua_rawsetfield(L, -2, property.first.c_str());
-        }
-        instance->methods.insert(c->methods.begin(), c->methods.end());
-        instance->events.insert(instance->events.end(), c->events.begin(), c->events.end());
-        for (auto& event : c->events) {
-            pushNewRBXScriptSignal(L, event);
-            lua_rawsetfield(L, -2, event.c_str());
-        }
         if (c->constructor)
             c->constructor(L, instance);
         c = c->superclass.get();
     }
-    lua_pop(L, 1); // signallookup table
 
     // FIXME: more default values
     // FIXME: unique_id
-    setInstanceValue<bool>(instance, L, PROP_INSTANCE_ARCHIVABLE, true, true);
-    setInstanceValue<std::string>(instance, L, PROP_INSTANCE_NAME, class_name, true);
-    setInstanceValue<std::string>(instance, L, PROP_INSTANCE_CLASS_NAME, class_name, true);
+    setInstanceValue<bool>(instance, L, rbxInstance::archivable_slot, true, true);
+    setInstanceValue<std::string>(instance, L, rbxInstance::name_slot, class_name, true);
+    setInstanceValue<std::string>(instance, L, rbxInstance::class_name_slot, class_name, true);
     setInstanceParent(L, instance, parent);
 
     std::lock_guard instance_list_lock(rbxInstance::instance_list_mutex);
@@ -928,17 +1243,15 @@ std::shared_ptr<rbxInstance> newInstance(lua_State* L, const char* class_name, s
     return instance;
 }
 std::shared_ptr<rbxInstance> cloneInstance(lua_State* L, std::shared_ptr<rbxInstance> reference, bool is_deep, std::optional<std::map<std::shared_ptr<rbxInstance>, std::shared_ptr<rbxInstance>>*> cloned_map) {
-    auto instance = newInstance(L, getInstanceValue<std::string>(reference, PROP_INSTANCE_CLASS_NAME).c_str());
-    if (is_deep && !getInstanceValue<bool>(reference, PROP_INSTANCE_ARCHIVABLE))
+    auto instance = newInstance(L, getInstanceValue<std::string>(reference, rbxInstance::class_name_slot).c_str());
+    if (is_deep && !getInstanceValue<bool>(reference, rbxInstance::archivable_slot))
         return nullptr;
 
-    rbxClass* c = instance->_class.get();
-    while (c) {
-        for (auto& property : c->properties)
-            instance->values[property.first].value = reference->values[property.first].value;
-        c = c->superclass.get();
+    {
+    std::shared_lock reference_values_lock(reference->values_mutex);
+    instance->values = reference->values;
     }
-    instance->values[PROP_INSTANCE_PARENT].value = std::shared_ptr<rbxInstance>(nullptr);
+    instance->values[rbxInstance::parent_slot] = std::shared_ptr<rbxInstance>(nullptr);
 
     if (is_deep) {
         // FIXME: I think the fact that this function spends time with the lock unlocked is inheritly flawed.
@@ -973,18 +1286,13 @@ std::shared_ptr<rbxInstance> cloneInstance(lua_State* L, std::shared_ptr<rbxInst
         children_lock.lock();
 
         for (auto& pair : **cloned_map) {
-            // TODO: does it help or hurt performance for this `c` to be the same as the one above?
-            c = pair.second->_class.get();
-            while (c) {
-                for (auto& property : c->properties)
-                    if (property.second->type_category == Instance && property.first != PROP_INSTANCE_PARENT) {
-                        auto value = getInstanceValue<std::shared_ptr<rbxInstance>>(pair.second, property.first.c_str());
-                        auto it = (*cloned_map)->find(value);
-                        if (it != (*cloned_map)->end())
-                            setInstanceValue<std::shared_ptr<rbxInstance>>(pair.second, L, property.first.c_str(), it->second, true);
-                    }
-                c = c->superclass.get();
-            }
+            for (auto& property : pair.second->_class->slots)
+                if (property->type_category == Instance && property->slot != rbxInstance::parent_slot) {
+                    auto value = getInstanceValue<std::shared_ptr<rbxInstance>>(pair.second, property->slot);
+                    auto it = (*cloned_map)->find(value);
+                    if (it != (*cloned_map)->end())
+                        setInstanceValue<std::shared_ptr<rbxInstance>>(pair.second, L, property->slot, it->second, true);
+                }
         }
     }
 
@@ -1033,14 +1341,13 @@ static int fr_getcallbackvalue(lua_State* L) {
     auto instance = lua_checkinstance(L, 1);
     const char* key = luaL_checkstring(L, 2);
 
-    auto class_name = getInstanceValue<std::string>(instance, PROP_INSTANCE_CLASS_NAME);
-    if (instance->values.find(key) == instance->values.end()) {
-        auto name = getInstanceValue<std::string>(instance, PROP_INSTANCE_NAME);
+    auto class_name = getInstanceValue<std::string>(instance, rbxInstance::class_name_slot);
+    auto slot = instance->_class->findSlot(key);
+    if (!slot) {
+        auto name = getInstanceValue<std::string>(instance, rbxInstance::name_slot);
         luaL_error(L, "%s is not a valid member of %s \"%s\"", key, class_name.c_str(), name.c_str());
     }
-    auto value = &instance->values[key];
-
-    auto& wrapper = std::get<rbxCallback>(value->value);
+    auto& wrapper = getInstanceValue<rbxCallback>(instance, *slot);
     if (wrapper.index == -1)
         lua_pushnil(L);
     else {
@@ -1056,15 +1363,13 @@ static int fr_isscriptable(lua_State* L) {
     auto instance = lua_checkinstance(L, 1);
     const char* key = luaL_checkstring(L, 2);
 
-    auto class_name = getInstanceValue<std::string>(instance, PROP_INSTANCE_CLASS_NAME);
-    if (instance->values.find(key) == instance->values.end()) {
-        auto name = getInstanceValue<std::string>(instance, PROP_INSTANCE_NAME);
+    auto class_name = getInstanceValue<std::string>(instance, rbxInstance::class_name_slot);
+    auto slot = instance->_class->findSlot(key);
+    if (!slot) {
+        auto name = getInstanceValue<std::string>(instance, rbxInstance::name_slot);
         luaL_error(L, "%s is not a valid member of %s \"%s\"", key, class_name.c_str(), name.c_str());
     }
-    auto value = &instance->values[key];
-    auto property = value->property;
-
-    lua_pushboolean(L, !(property->tags & rbxProperty::NotScriptable));
+    lua_pushboolean(L, !(instance->getPropertyTags(*slot) & rbxProperty::NotScriptable));
     return 1;
 }
 static int fr_setscriptable(lua_State* L) {
@@ -1072,20 +1377,21 @@ static int fr_setscriptable(lua_State* L) {
     const char* key = luaL_checkstring(L, 2);
     const bool new_value = luaL_checkboolean(L, 3);
 
-    auto class_name = getInstanceValue<std::string>(instance, PROP_INSTANCE_CLASS_NAME);
-    if (instance->values.find(key) == instance->values.end()) {
-        auto name = getInstanceValue<std::string>(instance, PROP_INSTANCE_NAME);
+    auto class_name = getInstanceValue<std::string>(instance, rbxInstance::class_name_slot);
+    auto slot = instance->_class->findSlot(key);
+    if (!slot) {
+        auto name = getInstanceValue<std::string>(instance, rbxInstance::name_slot);
         luaL_error(L, "%s is not a valid member of %s \"%s\"", key, class_name.c_str(), name.c_str());
     }
-    auto value = &instance->values[key];
-    auto& property = value->property;
-
-    const bool old = !(property->tags & rbxProperty::NotScriptable);
+    uint8_t tags = instance->getPropertyTags(*slot);
+    const bool old = !(tags & rbxProperty::NotScriptable);
 
     if (new_value)
-        property->tags &= ~rbxProperty::NotScriptable;
+        tags &= ~rbxProperty::NotScriptable;
     else
-        property->tags |= rbxProperty::NotScriptable;
+        tags |= rbxProperty::NotScriptable;
+
+    instance->setPropertyTags(*slot, tags);
 
     lua_pushboolean(L, old);
     return 1;
@@ -1098,6 +1404,8 @@ static int fr_gethui(lua_State* L) {
 void rbxInstanceSetup(lua_State* L, std::string api_dump) {
     // rbxInstance::destructorL = TaskScheduler::newThread(L, [] (std::string error) { Console::ScriptConsole.error(error); });
 
+    MemberAtoms::install(L);
+
     // instancelookup
     newweaktable(L);
     lua_setfield(L, LUA_REGISTRYINDEX, INSTANCELOOKUP);
@@ -1158,6 +1466,8 @@ void rbxInstanceSetup(lua_State* L, std::string api_dump) {
             std::string member_name = member_json["Name"].template get<std::string>();
             std::string member_type = member_json["MemberType"].template get<std::string>();
 
+            MemberAtoms::intern(member_name);
+
             bool default_exists = false;
             std::string default_value;
             {
@@ -1295,6 +1605,17 @@ void rbxInstanceSetup(lua_State* L, std::string api_dump) {
 
     superclass_map.clear();
 
+    auto& instance_class = rbxClass::class_map["Instance"];
+    rbxInstance::archivable_slot = instance_class->getSlot(PROP_INSTANCE_ARCHIVABLE);
+    rbxInstance::name_slot = instance_class->getSlot(PROP_INSTANCE_NAME);
+    rbxInstance::class_name_slot = instance_class->getSlot(PROP_INSTANCE_CLASS_NAME);
+    rbxInstance::parent_slot = instance_class->getSlot(PROP_INSTANCE_PARENT);
+    {
+        auto& events = instance_class->all_events;
+        rbxInstance::changed_event = std::find(events.begin(), events.end(), "Changed") - events.begin();
+        assert(rbxInstance::changed_event < events.size());
+    }
+
     rbxClass::class_map["Instance"]->methods.at("ClearAllChildren").func = rbxInstance_methods::clearAllChildren;
     rbxClass::class_map["Instance"]->methods.at("Clone").func = rbxInstance_methods::clone;
     rbxClass::class_map["Instance"]->methods.at("Destroy").func = rbxInstance_methods::destroy;
@@ -1352,7 +1673,7 @@ void rbxInstanceSetup(lua_State* L, std::string api_dump) {
     lua_setglobal(L, "workspace");
     lua_setglobal(L, "Workspace");
 
-    datamodel->values["Workspace"].value = workspace;
+    datamodel->values[datamodel->_class->getSlot("Workspace")] = workspace;
 
     rbxInstance_Players_init(L, datamodel);
 
@@ -1362,7 +1683,7 @@ void rbxInstanceSetup(lua_State* L, std::string api_dump) {
     auto coregui = ServiceProvider::getService(L, datamodel, "CoreGui");
     hiddenui = cloneInstance(L, coregui);
     // TODO: we could easily just create a new class called HiddenUi
-    hiddenui->values[PROP_INSTANCE_NAME].value = "HiddenUi";
+    hiddenui->values[rbxInstance::name_slot] = "HiddenUi";
 
     rbxInstance_CoreGui_setup(L, coregui);
 
@@ -1396,6 +1717,14 @@ void rbxInstanceSetup(lua_State* L, std::string api_dump) {
 
     pushFunctionFromLookup(L, fr_gethui, "gethui");
     lua_setglobal(L, "gethui");
+
+    // classes created after this point (and their instances) are finalized lazily by newInstance
+    for (auto& pair : rbxClass::class_map)
+        pair.second->finalize();
+
+    // strings created before the api dump was parsed (e.g. library names) get their member atoms now
+    MemberAtoms::retag(L);
+    MemberAtoms::freeze();
 }
 void rbxInstanceCleanup(lua_State* L) {
 }
@@ -6,22 +6,25 @@ namespace frostbyte {
 std::shared_ptr<rbxInstance> rbxPlayer::localplayer;
 std::shared_ptr<rbxInstance> rbxPlayer::localmouse;
 
+static rbxClass* player_class; // resolved in rbxInstance_Player_init
+
 namespace rbxInstance_Player_methods {
     static int getMouse(lua_State* L) {
-        lua_checkinstance(L, 1, "Player");
+        lua_checkinstance(L, 1, player_class);
         return lua_pushinstance(L, rbxPlayer::localmouse);
     }
 }; // namespace rbxInstance_Player_methods
 
 void rbxInstance_Player_init(lua_State *L, std::shared_ptr<rbxInstance> players_service) {
+    player_class = rbxClass::class_map.at("Player").get();
     rbxClass::class_map["Player"]->methods["GetMouse"].func = rbxInstance_Player_methods::getMouse;
 
     rbxPlayer::localplayer = newInstance(L, "Player", players_service);
     rbxPlayer::localmouse = newInstance(L, "Mouse");
 
-    rbxPlayer::localplayer->values[PROP_INSTANCE_NAME].value = "LocalPlayer";
+    rbxPlayer::localplayer->values[rbxInstance::name_slot] = "LocalPlayer";
 
-    players_service->values["LocalPlayer"].value = rbxPlayer::localplayer;
+    players_service->values[players_service->_class->getSlot("LocalPlayer")] = rbxPlayer::localplayer;
 }
 
 }; // namespace frostbyte
@@ -4,9 +4,11 @@
 
 namespace frostbyte {
 
+static rbxClass* players_class; // resolved in rbxInstance_Players_init
+
 namespace rbxInstance_Players_methods {
     static int getPlayers(lua_State* L) {
-        lua_checkinstance(L, 1, "Players");
+        lua_checkinstance(L, 1, players_class);
 
         createweaktable(L, 1, 0);
         lua_pushinstance(L, rbxPlayer::localplayer);
@@ -17,6 +19,7 @@ namespace rbxInstance_Players_methods {
 }; // namespace rbxInstance_Players_methods
 
 void rbxInstance_Players_init(lua_State* L, std::shared_ptr<rbxInstance> datamodel) {
+    players_class = rbxClass::class_map.at("Players").get();
     rbxClass::class_map["Players"]->methods["GetPlayers"].func = rbxInstance_Players_methods::getPlayers;
 
     auto players_service = ServiceProvider::getService(L, datamodel, "Players");
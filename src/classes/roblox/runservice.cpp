@@ -4,6 +4,7 @@
 
 #include "common.hpp"
 #include "console.hpp"
+#include "taskscheduler.hpp"
 #include "lua.h"
 #include "lualib.h"
 
@@ -21,11 +22,13 @@ static int compare(lua_State* L) {
     return 1;
 }
 
+static rbxClass* runservice_class; // resolved in rbxInstance_RunService_init
+
 namespace rbxInstance_RunService_methods {
     static int bindToRenderStep(lua_State* L) {
         std::lock_guard lock(bind_list_mutex);
 
-        lua_checkinstance(L, 1, "RunService");
+        lua_checkinstance(L, 1, runservice_class);
         const char* name = luaL_checkstring(L, 2);
         luaL_checkinteger(L, 3);
         luaL_checktype(L, 4, LUA_TFUNCTION);
@@ -65,7 +68,7 @@ namespace rbxInstance_RunService_methods {
     static int unbindFromRenderStep(lua_State* L) {
         std::lock_guard lock(bind_list_mutex);
 
-        lua_checkinstance(L, 1, "RunService");
+        lua_checkinstance(L, 1, runservice_class);
         const char* name = luaL_checkstring(L, 2);
 
         lua_rawgetfield(L, LUA_REGISTRYINDEX, BINDLIST_KEY);
@@ -92,11 +95,11 @@ void fireEventWithDelta(lua_State* L, const char* event, std::shared_ptr<rbxInst
     lua_call(L, 2, 0);
 }
 
-double last_clock = lua_clock();
+double last_clock = TaskScheduler::getTime();
 void RunService::process(lua_State *L) {
     std::lock_guard lock(bind_list_mutex);
 
-    const double clock = lua_clock();
+    const double clock = TaskScheduler::getTime();
     const double delta = clock - last_clock;
     last_clock = clock;
 
@@ -128,6 +131,7 @@ void RunService::process(lua_State *L) {
 }
 
 void rbxInstance_RunService_init(lua_State* L) {
+    runservice_class = rbxClass::class_map.at("RunService").get();
     lua_newtable(L);
 
     lua_rawsetfield(L, LUA_REGISTRYINDEX, BINDLIST_KEY);
@@ -30,9 +30,11 @@ std::shared_ptr<rbxInstance> ServiceProvider::getService(lua_State* L, std::shar
     return ServiceProvider::service_map[service];
 }
 
+static rbxClass* serviceprovider_class; // resolved in rbxInstance_ServiceProvider_init
+
 namespace rbxInstance_ServiceProvider_methods {
     static int findService(lua_State* L) {
-        std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1, "ServiceProvider");
+        std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1, serviceprovider_class);
         const char* service = luaL_checkstring(L, 2);
 
         if (std::find(rbxClass::valid_services.begin(), rbxClass::valid_services.end(), service) == rbxClass::valid_services.end())
@@ -46,7 +48,7 @@ namespace rbxInstance_ServiceProvider_methods {
         return 1;
     }
     static int getService(lua_State* L) {
-        std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1, "ServiceProvider");
+        std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1, serviceprovider_class);
         const char* service = luaL_checkstring(L, 2);
 
         if (std::find(rbxClass::valid_services.begin(), rbxClass::valid_services.end(), service) == rbxClass::valid_services.end())
@@ -59,6 +61,7 @@ namespace rbxInstance_ServiceProvider_methods {
 };
 
 void rbxInstance_ServiceProvider_init(lua_State *L) {
+    serviceprovider_class = rbxClass::class_map.at("ServiceProvider").get();
     rbxClass::class_map["ServiceProvider"]->methods.at("FindService").func = rbxInstance_ServiceProvider_methods::findService;
     rbxClass::class_map["ServiceProvider"]->methods.at("GetService").func = rbxInstance_ServiceProvider_methods::getService;
   
@@ -11,9 +11,11 @@ namespace frostbyte {
 std::shared_ptr<rbxInstance> notification_frame_title_template;
 std::shared_ptr<rbxInstance> notification_frame_text_template;
 
+static rbxClass* startergui_class; // resolved in rbxInstance_StarterGui_init
+
 namespace rbxInstance_StarterGui_methods {
     static int setCore(lua_State* L) {
-        lua_checkinstance(L, 1, "StarterGui");
+        lua_checkinstance(L, 1, startergui_class);
         const char* parameter = luaL_checkstring(L, 2);
 
         if (strequal(parameter, "SendNotification")) {
@@ -59,6 +61,7 @@ namespace rbxInstance_StarterGui_methods {
 }; // rbxInstance_StarterGui_methods
 
 void rbxInstance_StarterGui_init(lua_State* L) {
+    startergui_class = rbxClass::class_map.at("StarterGui").get();
     rbxClass::class_map["StarterGui"]->methods["SetCore"].func = rbxInstance_StarterGui_methods::setCore;
 
     notification_frame_title_template = newInstance(L, "TextLabel");
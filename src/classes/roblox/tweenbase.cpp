@@ -4,21 +4,23 @@
 
 namespace frostbyte {
 
+static rbxClass* tweenbase_class; // resolved in rbxInstance_TweenBase_init
+
 namespace rbxInstance_TweenBase_methods {
     static int cancel(lua_State* L) {
-        auto instance = lua_checkinstance(L, 1, "TweenBase");
+        auto instance = lua_checkinstance(L, 1, tweenbase_class);
 
         TweenService::cancelTween(L, instance);
         return 0;
     }
     static int play(lua_State* L) {
-        auto instance = lua_checkinstance(L, 1, "TweenBase");
+        auto instance = lua_checkinstance(L, 1, tweenbase_class);
 
         TweenService::activateTween(L, instance);
         return 0;
     }
     static int pause(lua_State* L) {
-        auto instance = lua_checkinstance(L, 1, "TweenBase");
+        auto instance = lua_checkinstance(L, 1, tweenbase_class);
 
         TweenService::pauseTween(L, instance);
         return 0;
@@ -26,6 +28,7 @@ namespace rbxInstance_TweenBase_methods {
 }; // rbxInstance_TweenBase_methods
 
 void rbxInstance_TweenBase_init() {
+    tweenbase_class = rbxClass::class_map.at("TweenBase").get();
     rbxClass::class_map["TweenBase"]->constructor = [](lua_State* L, std::shared_ptr<rbxInstance> instance) {
         getInstanceValue<EnumItemWrapper>(instance, "PlaybackState").name = "Begin";
     };
@@ -5,6 +5,7 @@
 #include "classes/tweeninfo.hpp"
 
 #include "common.hpp"
+#include "taskscheduler.hpp"
 #include "tween_functions.hpp"
 
 #include "lua.h"
@@ -32,7 +33,7 @@ void TweenService::activateTween(lua_State* L, std::shared_ptr<rbxInstance> twee
 
     const bool was_paused = playback_state.name == "Paused";
 
-    const double clock = lua_clock();
+    const double clock = TaskScheduler::getTime();
 
     tween_object.tween_func = linear;
     switch (getEnumItemFromWrapper(tween_info.easing_direction).value) {
@@ -233,7 +234,7 @@ void TweenService::process(lua_State *L) {
     static std::vector<std::shared_ptr<rbxInstance>> completed_tween_list;
     completed_tween_list.clear();
 
-    const double clock = lua_clock();
+    const double clock = TaskScheduler::getTime();
     for (size_t i = 0; i < TweenService::active_tween_list.size(); i++) {
         auto& tween_instance = TweenService::active_tween_list[i];
         auto& tween_object = tween_instance_to_object_map.at(tween_instance);
@@ -426,9 +427,11 @@ void TweenService::process(lua_State *L) {
     }
 }
 
+static rbxClass* tweenservice_class; // resolved in rbxInstance_TweenService_init
+
 namespace rbxInstance_TweenService_methods {
     static int create(lua_State* L) {
-        lua_checkinstance(L, 1, "TweenService");
+        lua_checkinstance(L, 1, tweenservice_class);
         auto instance = lua_checkinstance(L, 2);
         auto tweeninfo = lua_checktweeninfo(L, 3);
         luaL_checktype(L, 4, LUA_TTABLE);
@@ -602,6 +605,7 @@ namespace rbxInstance_TweenService_static_methods {
 }; // namespace rbxInstance_TweenService_methods
 
 void rbxInstance_TweenService_init() {
+    tweenservice_class = rbxClass::class_map.at("TweenService").get();
     rbxClass::class_map["TweenService"]->methods["Create"].func = rbxInstance_TweenService_methods::create;
 
     rbxClass::class_map["TweenService"]->methods["GetValue"].func = rbxInstance_TweenService_static_methods::getValue;
@@ -235,6 +235,8 @@ struct InputEvent {
     };
 };
 
+static rbxClass* guibutton_class; // resolved in rbxInstance_UserInputService_init
+
 std::queue<InputEvent> input_event_queue;
 std::mutex input_event_mutex;
 
@@ -488,7 +490,7 @@ void UserInputService::process(lua_State *L, bool anyImGui) {
             }
         }
 
-        if (has_instance && event_instance->isA("GuiButton")) {
+        if (has_instance && event_instance->isA(guibutton_class)) {
             // if this behavior seems weird, note that it's accurate!
             if (event.type == InputEvent::MouseMovement && event.state == InputEnded && !IsMouseButtonDown(0))
                 setInstanceValue(event_instance, L, "internal_CanActivate", false);
@@ -502,7 +504,7 @@ void UserInputService::process(lua_State *L, bool anyImGui) {
                 if (!instance)
                     continue;
 
-                if (!instance->isA("GuiButton"))
+                if (!instance->isA(guibutton_class))
                     continue;
 
                 setInstanceValue(instance, L, "internal_Click1Step1", false, true);
@@ -519,14 +521,16 @@ void UserInputService::process(lua_State *L, bool anyImGui) {
 
 #undef keyShifted
 
+static rbxClass* userinputservice_class; // resolved in rbxInstance_UserInputService_init
+
 namespace rbxInstance_UserInputService_methods {
     static int getMouseLocation(lua_State* L) {
-        lua_checkinstance(L, 1, "UserInputService");
+        lua_checkinstance(L, 1, userinputservice_class);
 
         return pushVector2(L, UserInputService::mouse_position);
     }
     static int isMouseButtonPressed(lua_State* L) {
-        lua_checkinstance(L, 1, "UserInputService");
+        lua_checkinstance(L, 1, userinputservice_class);
 
         luaL_argcheck(L, lua_isnumber(L, 2) || lua_isuserdata(L, 2), 2, "expected number or userdata");
 
@@ -547,6 +551,9 @@ namespace rbxInstance_UserInputService_methods {
 }; // namespace rbxInstance_UserInputService_methods
 
 void rbxInstance_UserInputService_init() {
+    userinputservice_class = rbxClass::class_map.at("UserInputService").get();
+    guibutton_class = rbxClass::class_map.at("GuiButton").get();
+
     UserInputService::signalMouseMovement(nullptr, InputBegan);
 
     rbxClass::class_map["UserInputService"]->methods["GetMouseLocation"].func = rbxInstance_UserInputService_methods::getMouseLocation;
@@ -8,8 +8,22 @@ void displayHelp(const char* filename) {
     printf("frostbyte by techhog\n"
         "usage: %s [options]\n\n"
         "options:\n"
-        "  -h           -  displays this page\n"
-        "  --nosandbox  -  disables sandboxing (Luau will perform less optimizations, but functions like getgenv need this flag to work)\n"
+        "  -h                   -  displays this page\n"
+        "  --nosandbox          -  disables sandboxing (Luau will perform less optimizations, but functions like getgenv need this flag to work)\n"
+        "  --headless           -  runs without a window or GPU; output goes to stdout and nothing is drawn\n"
+        "  --bytecode-cache     -  keeps compiled scripts in $HOME/frostbyte/bytecode so unchanged scripts skip the compiler on later runs\n"
+        "  --run=<file>         -  runs a script on startup (can be repeated)\n"
+        "  --batch=<file>       -  runs each script listed in file (one path per line) in turn in one headless process, printing PASS or FAIL for each\n"
+        "  --batch-timeout=<s>  -  how long a --batch script may keep running before it fails (default 30)\n"
+        "  --compile=<profile>  -  default (optimization level 1), release (level 2, which inlines and unrolls loops) or debug (level 0 with local names)\n"
+        "  --native             -  compiles every script to native code (scripts starting with --!native are compiled either way)\n"
+        "  --tests              -  runs the test suite on startup; the exit code is 1 if a test or --run script fails\n"
+        "  --tick-rate=<n>      -  sets the target fps, which headless mode uses as its tick rate (0 runs as fast as possible)\n"
+        "  --ticks=<n>          -  headless mode stops after n ticks instead of once no threads are left to run\n"
+        "  --resume-budget=<ms> -  how long a thread may run before it is yielded back to the scheduler (default 100, 0 disables)\n"
+        "  --kill-over-budget   -  kills threads that exceed --resume-budget with an error instead of yielding them\n"
+        "  --frame-budget=<n>   -  percent of each frame spent resuming threads before the rest wait for the next frame (default 0, no limit)\n"
+        "  --clock=<mode>       -  real (default), fixed (time moves 1/60s per frame) or deadline (like fixed, but idle frames skip to the next task.wait or task.delay)\n"
     , filename);
 }
 
@@ -8,6 +8,8 @@
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <unordered_map>
+#include <vector>
 
 #include "lua.h"
 #include "lualib.h"
@@ -18,6 +20,7 @@
 namespace frostbyte {
 
 bool print_stdout = false;
+bool headless = false;
 
 int countDecimals(double value) {
     double intpart;
@@ -274,7 +277,39 @@ int pushFunctionFromLookup(lua_State* L, lua_CFunction func, const char* name, l
     });
 }
 
-int addToLookup(lua_State *L, std::function<void()> pushValue, bool keep_value) {
+// native index of a lookup table's array part, so adding doesn't have to scan it.
+// only registered tables get one: they're strong and live in the registry forever, so their address identifies them and
+// their values' addresses can't be reused. weak lookups (enum items, DrawEntry objects) go through lookup_scan instead
+struct LookupRegistry {
+    std::unordered_map<const void*, int> index_of; // by lua_topointer of the value
+    std::vector<const void*> values; // by index - 1
+    std::vector<size_t> references; // by index - 1; 0 means the index is free
+    std::vector<int> free_indices;
+};
+static std::unordered_map<const void*, LookupRegistry> lookup_registries;
+
+void registerLookup(lua_State* L) {
+    lookup_registries.try_emplace(lua_topointer(L, -1));
+}
+
+// index bookkeeping for unregistered lookups. released slots are reused, and new ones go past every index handed out
+// so far rather than at the table's border, which is ambiguous once releases or collection leave holes.
+// nothing here is keyed by value, so a collected value's address being reused can't confuse it
+struct ScanLookup {
+    int size = 0; // highest index handed out
+    std::vector<int> free_indices;
+};
+static std::unordered_map<const void*, ScanLookup> scan_lookups;
+
+static ScanLookup& getScanLookup(lua_State* L, int idx) {
+    auto [it, inserted] = scan_lookups.try_emplace(lua_topointer(L, idx));
+    if (inserted)
+        it->second.size = lua_objlen(L, idx);
+    return it->second;
+}
+
+// dedupes with table.find; slow, but safe for weak tables whose values can be collected behind our back
+static int addToLookupByScan(lua_State* L, std::function<void()>& pushValue, bool keep_value) {
     pushValue();
 
     lua_getglobal(L, "table");
@@ -287,9 +322,18 @@ int addToLookup(lua_State *L, std::function<void()> pushValue, bool keep_value)
     lua_call(L, 2, 1);
 
     bool cached = lua_isnumber(L, -1);
-    int index = cached ? lua_tonumber(L, -1) : lua_objlen(L, -3) + 1;
+    int index = cached ? lua_tonumber(L, -1) : 0;
     lua_pop(L, 1); // table.find result
 
+    if (!cached) {
+        ScanLookup& scan = getScanLookup(L, -2);
+        if (!scan.free_indices.empty()) {
+            index = scan.free_indices.back();
+            scan.free_indices.pop_back();
+        } else
+            index = ++scan.size;
+    }
+
     if (cached) {
         if (!keep_value)
             lua_pop(L, 1);
@@ -304,6 +348,81 @@ int addToLookup(lua_State *L, std::function<void()> pushValue, bool keep_value)
     return index;
 }
 
+int addToLookup(lua_State *L, std::function<void()> pushValue, bool keep_value) {
+    auto registry_it = lookup_registries.find(lua_topointer(L, -1));
+    if (registry_it == lookup_registries.end())
+        return addToLookupByScan(L, pushValue, keep_value);
+    LookupRegistry& registry = registry_it->second;
+
+    pushValue();
+
+    // values without an identity (numbers, booleans) are never shared
+    const void* identity = lua_topointer(L, -1);
+    if (identity) {
+        auto it = registry.index_of.find(identity);
+        if (it != registry.index_of.end()) {
+            const int index = it->second;
+            registry.references[index - 1]++;
+
+            if (!keep_value)
+                lua_pop(L, 1);
+            lua_remove(L, -1 - keep_value); // pop lookup
+
+            return index;
+        }
+    }
+
+    int index;
+    if (!registry.free_indices.empty()) {
+        index = registry.free_indices.back();
+        registry.free_indices.pop_back();
+    } else {
+        registry.values.push_back(nullptr);
+        registry.references.push_back(0);
+        index = registry.values.size();
+    }
+
+    registry.values[index - 1] = identity;
+    registry.references[index - 1] = 1;
+    if (identity)
+        registry.index_of.emplace(identity, index);
+
+    if (keep_value)
+        lua_pushvalue(L, -1);
+    lua_rawseti(L, -2 - keep_value, index); // lookup[index] = value
+
+    lua_remove(L, -1 - keep_value); // pop lookup
+
+    return index;
+}
+void releaseFromLookup(lua_State* L, int index) {
+    auto registry_it = lookup_registries.find(lua_topointer(L, -1));
+    if (registry_it == lookup_registries.end()) {
+        getScanLookup(L, -1).free_indices.push_back(index);
+
+        lua_pushnil(L);
+        lua_rawseti(L, -2, index);
+        lua_pop(L, 1); // pop lookup
+        return;
+    }
+    LookupRegistry& registry = registry_it->second;
+    assert(index >= 1 && static_cast<size_t>(index) <= registry.references.size());
+
+    size_t& references = registry.references[index - 1];
+    assert(references > 0);
+    if (--references == 0) {
+        if (const void* identity = registry.values[index - 1])
+            registry.index_of.erase(identity);
+        registry.values[index - 1] = nullptr;
+        registry.free_indices.push_back(index);
+
+        lua_pushnil(L);
+        lua_rawseti(L, -2, index);
+    }
+
+    lua_pop(L, 1); // pop lookup
+}
+
 int addToStringLookup(lua_State *L, std::string string) {
     lua_getfield(L, LUA_REGISTRYINDEX, STRINGLOOKUP);
     return addToLookup(L, [&L, &string]{
@@ -1,8 +1,10 @@
 #include "console.hpp"
+#include "common.hpp"
 #include "imgui.h"
 #include "raylib.h"
 
 #include <cstdarg>
+#include <cstdio>
 
 namespace frostbyte {
 
@@ -126,6 +128,13 @@ std::string& Console::getWholeContent() {
 }
 
 void Console::log(std::string message, Message::Type type) {
+    // nothing renders the console without a window, so messages go straight to stdout instead of piling up
+    if (headless) {
+        if (type != Message::DEBUG || show_debug)
+            printf("%s %s\n", getMessageTypeString(type), message.c_str());
+        return;
+    }
+
     std::lock_guard lock(mutex);
     messages.push_back({ .type = type, .content = message });
 }
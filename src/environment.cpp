@@ -1,8 +1,11 @@
 #include "environment.hpp"
+#include "bytecodecache.hpp"
 #include "classes/roblox/datatypes/rbxscriptsignal.hpp"
+#include "classes/roblox/instance.hpp"
 #include "classes/roblox/runservice.hpp"
 #include "common.hpp"
 #include "libraries/drawentrylib.hpp"
+#include "nativecode.hpp"
 #include "ltable.h"
 #include "taskscheduler.hpp"
 
@@ -12,7 +15,6 @@
 #include <string>
 
 #include "Luau/Common.h"
-#include "Luau/Compiler.h"
 #include "lua.h"
 #include "lualib.h"
 #include "lgc.h"
@@ -98,12 +100,12 @@ static int fr_getallthreads(lua_State* L) {
     std::shared_lock lock(TaskScheduler::thread_list_mutex);
 
     createweaktable(L, TaskScheduler::thread_list.size(), 0);
-    for (size_t i = 0; i < TaskScheduler::thread_list.size();i ++) {
-        lua_State* thread = TaskScheduler::thread_list[i];
+    int i = 0;
+    for (lua_State* thread : TaskScheduler::thread_list) {
         // hack because I don't want to bring over api_incr_top
         lua_pushnil(L);
         setthvalue(L, L->top - 1, thread);
-        lua_rawseti(L, -2, i + 1);
+        lua_rawseti(L, -2, ++i);
     }
 
     return 1;
@@ -146,29 +148,118 @@ static int fr_loadstring(lua_State* L) {
 
     lua_setsafeenv(L, LUA_ENVIRONINDEX, false);
 
-    std::string bytecode = Luau::compile(std::string(s, l));
-    if (luau_load(L, chunkname, bytecode.data(), bytecode.size(), 0) == 0)
+    std::string bytecode = BytecodeCache::compile(std::string(s, l), chunkname);
+    if (luau_load(L, chunkname, bytecode.data(), bytecode.size(), 0) == 0) {
+        NativeCode::compile(L, -1);
         return 1;
+    }
 
     lua_pushnil(L);
     lua_insert(L, -2); // put before error message
     return 2;          // return nil plus error message
 }
 
+static int getCompileLevel(lua_State* L, const char* field, int max, int current) {
+    lua_getfield(L, 1, field);
+    if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        return current;
+    }
+
+    const int level = lua_tointeger(L, -1);
+    if (!lua_isnumber(L, -1) || level < 0 || level > max)
+        luaL_error(L, "%s must be between 0 and %d", field, max);
+    lua_pop(L, 1);
+    return level;
+}
+static void getCompileString(lua_State* L, const char* field, std::string& out) {
+    lua_getfield(L, 1, field);
+    if (!lua_isnil(L, -1)) {
+        if (lua_type(L, -1) != LUA_TSTRING)
+            luaL_error(L, "%s must be a string", field);
+        out.assign(lua_tostring(L, -1));
+    }
+    lua_pop(L, 1);
+}
+
+// fields left out keep their current value; an empty string clears a vector option
+static int fr_setcompileoptions(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    BytecodeCache::Profile profile = BytecodeCache::profile;
+    profile.optimization_level = getCompileLevel(L, "optimizationLevel", 2, profile.optimization_level);
+    profile.debug_level = getCompileLevel(L, "debugLevel", 2, profile.debug_level);
+    profile.type_info_level = getCompileLevel(L, "typeInfoLevel", 1, profile.type_info_level);
+    getCompileString(L, "vectorLib", profile.vector_lib);
+    getCompileString(L, "vectorCtor", profile.vector_ctor);
+    getCompileString(L, "vectorType", profile.vector_type);
+
+    lua_getfield(L, 1, "mutableGlobals");
+    if (!lua_isnil(L, -1)) {
+        if (!lua_istable(L, -1))
+            luaL_error(L, "mutableGlobals must be a table of strings");
+        profile.mutable_globals.clear();
+        for (int i = 1; lua_rawgeti(L, -1, i) != LUA_TNIL; i++) {
+            if (lua_type(L, -1) != LUA_TSTRING)
+                luaL_error(L, "mutableGlobals must be a table of strings");
+            profile.mutable_globals.emplace_back(lua_tostring(L, -1));
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+
+    BytecodeCache::profile = std::move(profile);
+    return 0;
+}
+static int fr_getcompileoptions(lua_State* L) {
+    const BytecodeCache::Profile& profile = BytecodeCache::profile;
+
+    lua_createtable(L, 0, 7);
+    lua_pushinteger(L, profile.optimization_level);
+    lua_setfield(L, -2, "optimizationLevel");
+    lua_pushinteger(L, profile.debug_level);
+    lua_setfield(L, -2, "debugLevel");
+    lua_pushinteger(L, profile.type_info_level);
+    lua_setfield(L, -2, "typeInfoLevel");
+    lua_pushstring(L, profile.vector_lib.c_str());
+    lua_setfield(L, -2, "vectorLib");
+    lua_pushstring(L, profile.vector_ctor.c_str());
+    lua_setfield(L, -2, "vectorCtor");
+    lua_pushstring(L, profile.vector_type.c_str());
+    lua_setfield(L, -2, "vectorType");
+
+    lua_createtable(L, profile.mutable_globals.size(), 0);
+    for (size_t i = 0; i < profile.mutable_globals.size(); i++) {
+        lua_pushstring(L, profile.mutable_globals[i].c_str());
+        lua_rawseti(L, -2, i + 1);
+    }
+    lua_setfield(L, -2, "mutableGlobals");
+
+    return 1;
+}
+
+// names match Roblox's Workspace.SignalBehavior; Deferred holds Changed fires until the end of the frame
+static const char* const signal_behavior_names[] = { "Immediate", "Deferred", nullptr };
+static int fr_setsignalbehavior(lua_State* L) {
+    rbxInstance::signal_behavior = static_cast<rbxInstance::SignalBehavior>(luaL_checkoption(L, 1, nullptr, signal_behavior_names));
+    return 0;
+}
+static int fr_getsignalbehavior(lua_State* L) {
+    lua_pushstring(L, signal_behavior_names[static_cast<int>(rbxInstance::signal_behavior)]);
+    return 1;
+}
+
 // a wait implementation that isn't built into the task scheduler because Roblox also has a deprecated wait global used before the task scheduler was introduced
 // NOTE: the default value should be 0.03
 static int fr_wait(lua_State* L) {
     const double seconds = getSeconds(L, 1);
-    auto before = std::chrono::system_clock::now();
-    auto end = std::chrono::system_clock::now() + std::chrono::duration<double>(seconds);
-
-    return TaskScheduler::yieldForWork(L, [before, end] (lua_State* thread) {
-        auto now = std::chrono::system_clock::now();
-        while (now < end)
-            now = std::chrono::system_clock::now();
+    const double before = TaskScheduler::getTime();
 
-        lua_pushnumber(thread, static_cast<std::chrono::duration<double>>(now - before).count());
-        lua_pushnumber(thread, lua_clock() - TaskScheduler::initial_client_time);
+    return TaskScheduler::yieldWithTimeout(L, seconds, [before] (lua_State* thread) {
+        const double now = TaskScheduler::getTime();
+        lua_pushnumber(thread, now - before);
+        lua_pushnumber(thread, now - TaskScheduler::initial_client_time);
         return 2;
     });
 }
@@ -295,7 +386,9 @@ static int fr_getfpscap(lua_State* L) {
 }
 
 static int fr_setwindowtitle(lua_State* L) {
-    SetWindowTitle(luaL_checkstring(L, 1));
+    const char* title = luaL_checkstring(L, 1);
+    if (!headless)
+        SetWindowTitle(title);
 
     return 0;
 }
@@ -355,13 +448,16 @@ static int fr_tick(lua_State* L) {
 void open_frostbyte_environment(lua_State *L) {
     // methodlookup
     lua_newtable(L);
+    registerLookup(L);
     lua_setfield(L, LUA_REGISTRYINDEX, METHODLOOKUP);
     // rbxscriptconnection_methodlookup
     lua_newtable(L);
+    registerLookup(L);
     lua_setfield(L, LUA_REGISTRYINDEX, RBXSCRIPTCONNECTION_METHODLOOKUP);
 
     // string list
     lua_newtable(L);
+    registerLookup(L);
     lua_setfield(L, LUA_REGISTRYINDEX, STRINGLOOKUP);
 
     lua_pushcfunction(L, fr_print, "print");
@@ -381,6 +477,10 @@ void open_frostbyte_environment(lua_State *L) {
     env_expose(wait)
 
     env_expose(loadstring)
+    env_expose(setcompileoptions)
+    env_expose(getcompileoptions)
+    env_expose(setsignalbehavior)
+    env_expose(getsignalbehavior)
 
     env_expose(gcstep)
     env_expose(gcfull)
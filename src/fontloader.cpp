@@ -16,6 +16,19 @@ void FontLoader::load() {
     font_list.reserve(font_count);
     font_name_list.reserve(font_count);
 
+    font_name_list.push_back("Default");
+    font_name_list.push_back("UI");
+    font_name_list.push_back("System");
+    font_name_list.push_back("Plex");
+    font_name_list.push_back("Monospace");
+
+    // fonts need a GPU texture, so headless runs get empty ones; measureText skips them
+    if (headless) {
+        for (size_t i = 0; i < font_count; i++)
+            font_list.push_back(new Font{});
+        return;
+    }
+
     Font font_default = GetFontDefault();
 
     std::string tmp_font_path;
@@ -39,18 +52,13 @@ void FontLoader::load() {
     font_list.push_back(new Font(font_proggy));
     font_list.push_back(new Font(font_plex));
     font_list.push_back(new Font(font_monospace));
-
-    font_name_list.push_back("Default");
-    font_name_list.push_back("UI");
-    font_name_list.push_back("System");
-    font_name_list.push_back("Plex");
-    font_name_list.push_back("Monospace");
 }
 void FontLoader::unload() {
     font_name_list.clear();
 
     for (unsigned int i = 0; i < font_list.size(); i++) {
-        UnloadFont(*font_list[i]);
+        if (!headless)
+            UnloadFont(*font_list[i]);
         delete font_list[i];
     }
     font_list.clear();
@@ -59,6 +67,12 @@ void FontLoader::unload() {
 }
 
 
+Vector2 FontLoader::measureText(const Font& font, const char* text, float size) {
+    if (headless || !font.glyphs)
+        return Vector2{ 0, 0 };
+    return MeasureTextEx(font, text, size, 0);
+}
+
 static bool checkSignatureTTF(const unsigned char* data, int data_size) {
     if (data_size < 4)
         return false;
@@ -95,7 +109,7 @@ size_t FontLoader::getFont(unsigned char *data, int data_size) {
 
     size_t index = font_count++;
 
-    Font* font = new Font(LoadFontFromMemory(file_extension, data, data_size, 256, nullptr, 0));
+    Font* font = headless ? new Font{} : new Font(LoadFontFromMemory(file_extension, data, data_size, 256, nullptr, 0));
 
     font_list.push_back(font);
     hash_font_map[hashed] = index;
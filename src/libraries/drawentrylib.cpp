@@ -45,7 +45,7 @@ drawEntryConstructor(Quad)
 
 size_t DrawEntryText::default_font = FontDefault;
 void DrawEntryText::updateTextBounds() {
-    text_bounds = MeasureTextEx(*font, text.c_str(), text_size, 0);
+    text_bounds = FontLoader::measureText(*font, text.c_str(), text_size);
 }
 void DrawEntryText::updateFont() {
     font = FontLoader::font_list[font_index];
@@ -84,11 +84,12 @@ void DrawEntryImage::updateData() {
 
     // clone so ImageResize only affects this image
     image = cloneImage(ImageLoader::getImage(data_ptr, data_size));
-    texture = LoadTextureFromImage(*image);
+    if (!headless)
+        texture = LoadTextureFromImage(*image);
     // TODO: istexturevalid here?
 
-    image_size.x = texture.width;
-    image_size.y = texture.height;
+    image_size.x = image->width;
+    image_size.y = image->height;
 
     if (size.x == 0 && size.y == 0)
         size = image_size;
@@ -99,10 +100,12 @@ void DrawEntryImage::resizeImage() {
     if (data.empty())
         return;
 
-    UnloadTexture(texture);
+    if (IsTextureValid(texture))
+        UnloadTexture(texture);
     ImageResize(image, size.x, size.y);
 
-    texture = LoadTextureFromImage(*image);
+    if (!headless)
+        texture = LoadTextureFromImage(*image);
 }
 
 void DrawEntry::onZIndexUpdate() {
@@ -144,12 +147,8 @@ void DrawEntry::destroy(lua_State* L, bool dont_erase) {
 
     luaL_getmetatable(L, "DrawEntry");
     lua_getfield(L, -1, "objects");
-
-    lua_pushnumber(L, lookup_index);
-    lua_pushnil(L);
-    lua_rawset(L, -3);
-
-    lua_pop(L, 2);
+    releaseFromLookup(L, lookup_index);
+    lua_pop(L, 1);
 
     free();
 }
@@ -4,6 +4,7 @@
 #include "classes/roblox/datatypes/rbxscriptsignal.hpp"
 #include "common.hpp"
 #include "console.hpp"
+#include "taskscheduler.hpp"
 
 #include <cassert>
 
@@ -480,6 +481,13 @@ void onEnableStephookChange(lua_State* L) {
         lua_callbacks(L)->debugstep = stephook;
     else
         lua_callbacks(L)->debugstep = nullptr;
+
+    // debugstep only fires in single-step mode, which also keeps native code from running, so it's only on while the hook is.
+    // new threads copy the flag from the thread that created them
+    lua_singlestep(L->global->mainthread, enable_stephook);
+    std::shared_lock lock(TaskScheduler::thread_list_mutex);
+    for (lua_State* thread : TaskScheduler::thread_list)
+        lua_singlestep(thread, enable_stephook);
 }
 
 }; // namespace frostbyte
@@ -1,12 +1,18 @@
 #include <cfloat>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <shared_mutex>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "basedrawing.hpp"
+#include "batchrunner.hpp"
+#include "bytecodecache.hpp"
 #include "classes/colorsequence.hpp"
 #include "classes/colorsequencekeypoint.hpp"
 #include "classes/numberrange.hpp"
@@ -18,6 +24,7 @@
 #include "libraries/cryptlib.hpp"
 #include "libraries/drawingimmediate.hpp"
 #include "libraries/filesystemlib.hpp"
+#include "nativecode.hpp"
 #include "raylib.h"
 #include "rlImGui.h"
 #include "imgui.h"
@@ -137,6 +144,17 @@ void tryRunCode(lua_State* L, const char* name, const char* code, size_t code_le
     }
 }
 
+// parses the value of a --name=<n> option into a non-negative integer
+bool parseCountOption(const char* option, const char* value, unsigned long& out) {
+    char* end;
+    out = strtoul(value, &end, 10);
+    if (*end != '\0' || value[0] == '-') {
+        fprintf(stderr, "ERROR: %s expects a non-negative integer\n", option);
+        return false;
+    }
+    return true;
+}
+
 Shader frostbyte::round_shader;
 
 int main(int argc, char** argv) {
@@ -148,14 +166,74 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    std::vector<std::string> run_paths;
+    bool run_tests_on_start = false;
+    unsigned long max_ticks = 0;
+    bool batch = false;
+
     for (unsigned i = 1; i < (unsigned) argc; i++) {
         const char* arg = argv[i];
+        unsigned long count;
         if (strequal(arg, "-h") || strequal(arg, "--help")) {
             displayHelp();
             return 0;
         } else if (strequal(arg, "--nosandbox"))
             TaskScheduler::sandboxing = false;
-        else {
+        else if (strequal(arg, "--headless"))
+            headless = true;
+        else if (strequal(arg, "--bytecode-cache"))
+            BytecodeCache::disk_enabled = true;
+        else if (handleRecordOption("--compile", arg) == 0) {
+            if (!BytecodeCache::selectProfile(arg)) {
+                fprintf(stderr, "ERROR: --compile expects default, release or debug\n");
+                return 1;
+            }
+        } else if (strequal(arg, "--native"))
+            NativeCode::enabled = true;
+        else if (strequal(arg, "--tests"))
+            run_tests_on_start = true;
+        else if (handleRecordOption("--run", arg) == 0)
+            run_paths.emplace_back(arg);
+        // --batch-timeout first, since --batch would match its prefix and complain about the missing equals sign
+        else if (handleRecordOption("--batch-timeout", arg) == 0) {
+            if (!parseCountOption("--batch-timeout", arg, count))
+                return 1;
+            BatchRunner::timeout = count;
+        } else if (handleRecordOption("--batch", arg) == 0) {
+            if (!BatchRunner::loadList(arg))
+                return 1;
+            batch = true;
+            headless = true;
+        } else if (handleRecordOption("--tick-rate", arg) == 0) {
+            if (!parseCountOption("--tick-rate", arg, count))
+                return 1;
+            TaskScheduler::target_fps = count;
+        } else if (handleRecordOption("--ticks", arg) == 0) {
+            if (!parseCountOption("--ticks", arg, max_ticks))
+                return 1;
+        } else if (handleRecordOption("--resume-budget", arg) == 0) {
+            if (!parseCountOption("--resume-budget", arg, count))
+                return 1;
+            TaskScheduler::resume_budget = count / 1000.0;
+        } else if (strequal(arg, "--kill-over-budget"))
+            TaskScheduler::kill_over_budget = true;
+        else if (handleRecordOption("--frame-budget", arg) == 0) {
+            if (!parseCountOption("--frame-budget", arg, count))
+                return 1;
+            TaskScheduler::frame_budget_share = count / 100.0;
+        }
+        else if (handleRecordOption("--clock", arg) == 0) {
+            if (strequal(arg, "real"))
+                TaskScheduler::setClockMode(ClockMode::Real);
+            else if (strequal(arg, "fixed"))
+                TaskScheduler::setClockMode(ClockMode::FixedStep);
+            else if (strequal(arg, "deadline"))
+                TaskScheduler::setClockMode(ClockMode::NextDeadline);
+            else {
+                fprintf(stderr, "ERROR: --clock expects real, fixed or deadline\n");
+                return 1;
+            }
+        } else {
             fprintf(stderr, "ERROR: unrecognized option '%s'\n", arg);
             return 1;
         }
@@ -200,6 +278,7 @@ int main(int argc, char** argv) {
     curl_global_init(CURL_GLOBAL_DEFAULT);
 
     lua_State* L = luaL_newstate();
+    NativeCode::setup(L);
     luaL_openlibs(L);
 
     TaskScheduler::setup(L);
@@ -241,11 +320,13 @@ int main(int argc, char** argv) {
     UI_FunctionExplorer_init(L, DataModel::instance);
     ImGuiService_init(L, DataModel::instance);
 
-    SetTraceLogLevel(LOG_WARNING);
-    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
-    InitWindow(800, 600, "frostbyte");
-    SetExitKey(KEY_NULL);
-    SetTargetFPS(TaskScheduler::target_fps);
+    if (!headless) {
+        SetTraceLogLevel(LOG_WARNING);
+        SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+        InitWindow(800, 600, "frostbyte");
+        SetExitKey(KEY_NULL);
+        SetTargetFPS(TaskScheduler::target_fps);
+    }
 
     // load fonts before opening drawentry lib and after InitWindow. This means that we have to push some lua state stuff after window creation
     FontLoader::load();
@@ -261,8 +342,6 @@ int main(int argc, char** argv) {
     lua_getglobal(L, "shared");
     lua_setreadonly(L, -1, false);
 
-    lua_singlestep(L, true); // needed for stephook
-
     lua_State* appL = TaskScheduler::newThread(L, [] (std::string error) { Console::ScriptConsole.error(error); });
     lua_pop(L, 1);
     Console::ScriptConsole.debugf("app state: %p", appL);
@@ -294,6 +373,7 @@ int main(int argc, char** argv) {
 
     lua_State* dont_kill_thread_list[4] = { appL, userL, testL, fontL };
     lua_State** dont_kill_thread_list_end = dont_kill_thread_list + IM_ARRAYSIZE(dont_kill_thread_list);
+    BatchRunner::protected_threads.assign(dont_kill_thread_list, dont_kill_thread_list_end);
 
     bool all_tests_succeeded = false;
     bool has_tested = false;
@@ -302,9 +382,33 @@ int main(int argc, char** argv) {
 
     setupTests(&is_running_tests, &all_tests_succeeded);
 
+    if (run_tests_on_start) {
+        has_tested = true;
+        is_running_tests = true;
+        should_run_tests = true;
+    }
+
+    bool script_failed = false;
+    size_t unfinished_scripts = 0; // --run scripts whose thread is still alive
+    for (auto& path : run_paths) {
+        try {
+            std::string contents = readFileToString(path.c_str());
+            unfinished_scripts++;
+            TaskScheduler::startCodeOnNewThread(userL, path.c_str(), contents.c_str(), contents.length(), [&script_failed] (std::string error) {
+                Console::ScriptConsole.error(error);
+                script_failed = true;
+            }, [&unfinished_scripts] {
+                unfinished_scripts--;
+            });
+        } catch (std::exception& e) {
+            Console::ScriptConsole.errorf("failed to run %s: %s", path.c_str(), e.what());
+            script_failed = true;
+        }
+    }
+
     pushNewScriptEditorTab();
 
-    {
+    if (!headless) {
         std::string base_path = FileSystem::home_path;
         base_path.append("assets/base.vs");
         std::string rounded_path = FileSystem::home_path;
@@ -317,9 +421,8 @@ int main(int argc, char** argv) {
             return 1;
         }
     }
-    float shader_zero = 0.f;
-
-    {
+    if (!headless) {
+        float shader_zero = 0.f;
         float vec4[] = { 5.f, 5.f, 5.f, 5.f };
         float vec2[] = { 0.f, 0.f };
         SetShaderValue(round_shader, GetShaderLocation(round_shader, "radius"), vec4, SHADER_UNIFORM_VEC4);
@@ -329,9 +432,10 @@ int main(int argc, char** argv) {
         SetShaderValue(round_shader, GetShaderLocation(round_shader, "borderThickness"), &shader_zero, SHADER_UNIFORM_FLOAT);
     }
 
-    rlImGuiSetup(true);
+    if (!headless)
+        rlImGuiSetup(true);
 
-    {
+    if (!headless) {
     // ImGui theme from https://gist.github.com/enemymouse/c8aa24e247a1d7b9fc33d45091cbb8f0
     ImGuiStyle& style = ImGui::GetStyle();
     style.Alpha = 1.0;
@@ -387,7 +491,58 @@ int main(int argc, char** argv) {
     style.Colors[ImGuiCol_ModalWindowDimBg] = ImVec4(0.04f, 0.10f, 0.09f, 0.51f);
     }
 
-    while (!WindowShouldClose() && !DataModel::shutdown) {
+    unsigned long tick_count = 0;
+
+    while (!DataModel::shutdown && (headless || !WindowShouldClose())) {
+        // the same steps as below without input, camera or rendering; stops after --ticks ticks, or once nothing is left to run
+        if (headless) {
+            const double tick_start = lua_clock();
+            TaskScheduler::advanceClock();
+
+            if (enable_run_service)
+                RunService::process(appL);
+            if (enable_tween_service)
+                TweenService::process(appL);
+
+            TaskScheduler::run();
+            rbxInstance::flushDeferredChanges(appL);
+
+            if (should_run_tests) {
+                should_run_tests = false;
+                startAllTests(testL);
+            }
+
+            setInstanceValue<double>(Workspace::instance, appL, "DistributedGameTime", TaskScheduler::getTime() - initial_game_time);
+            rbxInstance::flushDeferredChanges(appL);
+
+            // a batch ends once its last script has finished rather than when the scheduler first goes idle
+            if (batch && !BatchRunner::step(userL))
+                break;
+
+            tick_count++;
+            if (max_ticks ? tick_count >= max_ticks : !batch && !is_running_tests && !TaskScheduler::hasPendingWork()) {
+                // a --run script that --ticks stopped before it finished fails the run
+                if (max_ticks && unfinished_scripts > 0) {
+                    Console::ScriptConsole.errorf("%zu --run script(s) still running after %lu ticks", unfinished_scripts, max_ticks);
+                    script_failed = true;
+                }
+                break;
+            }
+
+            // target_fps doubles as the tick rate; 0 ticks as fast as possible
+            if (TaskScheduler::target_fps > 0) {
+                TaskScheduler::gcIdleStep(appL, tick_start + 1.0 / TaskScheduler::target_fps);
+
+                const double remaining = 1.0 / TaskScheduler::target_fps - (lua_clock() - tick_start);
+                if (remaining > 0)
+                    std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
+            }
+            continue;
+        }
+
+        TaskScheduler::advanceClock();
+        const double frame_start = lua_clock();
+
         const bool anyImGui = ImGui::IsWindowHovered(ImGuiHoveredFlags_AnyWindow);
         if (enable_user_input_service)
             UserInputService::process(appL, anyImGui);
@@ -397,6 +552,7 @@ int main(int argc, char** argv) {
             TweenService::process(appL);
 
         TaskScheduler::run();
+        rbxInstance::flushDeferredChanges(appL);
 
         int screen_width = GetScreenWidth();
         int screen_height = GetScreenHeight();
@@ -424,6 +580,7 @@ int main(int argc, char** argv) {
             if (ImGui::BeginMenu("Options")) {
                 ImGui::BeginDisabled();
                 ImGui::Text("sandboxing - %s", TaskScheduler::sandboxing ? "enabled" : "disabled");
+                ImGui::Text("deferred changes fired - %zu", rbxInstance::deferred_fired_count);
                 ImGui::EndDisabled();
 
                 ImGui::MenuItem("print routes to stdout", nullptr, &print_stdout);
@@ -451,6 +608,9 @@ int main(int argc, char** argv) {
                 ImGui::MenuItem("Enable UserInputService", nullptr, &enable_user_input_service);
                 ImGui::MenuItem("Enable RunService", nullptr, &enable_run_service);
                 ImGui::MenuItem("Enable TweenService", nullptr, &enable_tween_service);
+                bool deferred_signals = rbxInstance::signal_behavior == rbxInstance::SignalBehavior::Deferred;
+                if (ImGui::MenuItem("Deferred Signals", nullptr, &deferred_signals))
+                    rbxInstance::signal_behavior = deferred_signals ? rbxInstance::SignalBehavior::Deferred : rbxInstance::SignalBehavior::Immediate;
                 ImGui::MenuItem("Function Explorer", nullptr, &menu_function_explorer_open);
                 ImGui::MenuItem("Table Explorer", nullptr, &menu_table_explorer_open);
                 ImGui::MenuItem("Image Explorer", nullptr, &menu_image_explorer_open);
@@ -686,9 +846,27 @@ int main(int argc, char** argv) {
             if (ImGui::Begin("Thread List", &menu_thread_list_open)) {
                 lua_State* thread_to_kill = nullptr;
 
+                ImGui::Text("resumed last frame: %zu, carried: %zu, frames over budget: %llu", TaskScheduler::run_stats.resumed, TaskScheduler::run_stats.carried, static_cast<unsigned long long>(TaskScheduler::run_stats.over_budget_runs));
+                ImGui::InputDouble("frame budget share", &TaskScheduler::frame_budget_share, 0.05, 0.25, "%.2f");
+                ImGui::InputDouble("resume budget (s)", &TaskScheduler::resume_budget, 0.01, 0.1, "%.3f");
+                ImGui::Checkbox("kill threads over budget", &TaskScheduler::kill_over_budget);
+                ImGui::Checkbox("idle GC", &TaskScheduler::idle_gc);
+                ImGui::SameLine();
+                ImGui::Text("%.2f ms last frame, %zu steps of %d KB, %zu KB allocated, %zu KB owed", TaskScheduler::gc_stats.time * 1000.0, TaskScheduler::gc_stats.steps, TaskScheduler::gc_stats.step_kb, TaskScheduler::gc_stats.allocated / 1024, TaskScheduler::gc_stats.debt / 1024);
+                ImGui::Text("bytecode cache: %zu hits, %zu from disk, %zu compiled, %zu entries", BytecodeCache::stats.hits, BytecodeCache::stats.disk_hits, BytecodeCache::stats.misses, BytecodeCache::size());
+                ImGui::SameLine();
+                if (ImGui::SmallButton("Clear"))
+                    BytecodeCache::clear();
+                if (NativeCode::isSupported()) {
+                    ImGui::Checkbox("native codegen", &NativeCode::enabled);
+                    ImGui::SameLine();
+                    ImGui::Text("%zu of %zu functions compiled in %zu chunks (%zu KB), %zu failed", NativeCode::stats.functions_compiled, NativeCode::stats.functions_total, NativeCode::stats.chunks, NativeCode::stats.code_bytes / 1024, NativeCode::stats.failures);
+                } else
+                    ImGui::TextDisabled("native codegen isn't supported on this platform");
+                ImGui::Separator();
+
                 std::shared_lock lock(TaskScheduler::thread_list_mutex);
-                for (size_t i = 0; i < TaskScheduler::thread_list.size();i ++) {
-                    lua_State* thread = TaskScheduler::thread_list[i];
+                for (lua_State* thread : TaskScheduler::thread_list) {
                     Task* task = getTask(thread);
                     std::string identifier = task->identifier;
 
@@ -768,6 +946,10 @@ int main(int argc, char** argv) {
 
         rlImGuiEnd();
 
+        // EndDrawing waits out the rest of the frame anyway, so spend that time on GC
+        if (TaskScheduler::target_fps > 0)
+            TaskScheduler::gcIdleStep(appL, frame_start + 1.0 / TaskScheduler::target_fps);
+
         EndDrawing();
 
         if (should_run_tests) {
@@ -775,20 +957,26 @@ int main(int argc, char** argv) {
             startAllTests(testL);
         }
 
-        setInstanceValue<double>(Workspace::instance, appL, "DistributedGameTime", lua_clock() - initial_game_time);
+        setInstanceValue<double>(Workspace::instance, appL, "DistributedGameTime", TaskScheduler::getTime() - initial_game_time);
+
+        // changes made while rendering
+        rbxInstance::flushDeferredChanges(appL);
     }
     DataModel::onShutdown(appL);
 
-    UnloadShader(round_shader);
+    if (!headless)
+        UnloadShader(round_shader);
 
     for (auto& entry : DrawEntry::draw_list)
         entry->free();
 
-    rlImGuiShutdown();
+    if (!headless)
+        rlImGuiShutdown();
     FontLoader::unload();
     UI_ImageExplorer_cleanup();
     ImageLoader::unload();
-    CloseWindow();
+    if (!headless)
+        CloseWindow();
 
     rbxInstanceCleanup(appL);
 
@@ -802,5 +990,11 @@ int main(int argc, char** argv) {
 
     curl_global_cleanup();
 
+    if (batch)
+        printf("%zu of %zu scripts passed\n", BatchRunner::passed_count, BatchRunner::paths.size());
+
+    // --run scripts cut short by --ticks count as failures too
+    if (script_failed || (batch && BatchRunner::passed_count != BatchRunner::paths.size()) || (run_tests_on_start && !all_tests_succeeded))
+        return 1;
     return 0;
 }
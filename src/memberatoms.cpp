@@ -0,0 +1,100 @@
+#include "memberatoms.hpp"
+
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+
+#include "lstate.h"
+
+namespace frostbyte {
+
+std::deque<std::string> MemberAtoms::names;
+std::deque<MemberAtoms::AtomMap> MemberAtoms::atom_maps(1);
+std::atomic<const MemberAtoms::AtomMap*> MemberAtoms::frozen_map = nullptr;
+std::shared_mutex MemberAtoms::mutex;
+
+int16_t MemberAtoms::findIn(const AtomMap& map, std::string_view name) {
+    auto it = map.find(name);
+    if (it == map.end())
+        return NO_ATOM;
+    return it->second;
+}
+
+int16_t MemberAtoms::intern(std::string_view name) {
+    std::lock_guard lock(mutex);
+
+    int16_t atom = findIn(atom_maps.back(), name);
+    if (atom != NO_ATOM)
+        return atom;
+
+    if (names.size() > static_cast<size_t>(std::numeric_limits<int16_t>::max()))
+        throw std::runtime_error("too many member names to intern");
+
+    atom = static_cast<int16_t>(names.size());
+    names.emplace_back(name);
+
+    if (frozen_map.load(std::memory_order_relaxed)) {
+        AtomMap next = atom_maps.back();
+        next.emplace(names.back(), atom);
+        atom_maps.push_back(std::move(next));
+        frozen_map.store(&atom_maps.back(), std::memory_order_release);
+    } else
+        atom_maps.back().emplace(names.back(), atom);
+
+    return atom;
+}
+int16_t MemberAtoms::find(const char* s, size_t l) {
+    if (const AtomMap* map = frozen_map.load(std::memory_order_acquire))
+        return findIn(*map, std::string_view(s, l));
+
+    std::shared_lock lock(mutex);
+    return findIn(atom_maps.back(), std::string_view(s, l));
+}
+const std::string& MemberAtoms::name(int16_t atom) {
+    std::shared_lock lock(mutex);
+    return names.at(atom);
+}
+size_t MemberAtoms::count() {
+    std::shared_lock lock(mutex);
+    return names.size();
+}
+
+// useratom gained a lua_State* parameter in newer Luau releases
+template<typename Callbacks>
+static void setUserAtom(Callbacks* callbacks) {
+    if constexpr (std::is_assignable_v<decltype(callbacks->useratom)&, int16_t (*)(const char*, size_t)>)
+        callbacks->useratom = [](const char* s, size_t l) -> int16_t {
+            return MemberAtoms::find(s, l);
+        };
+    else
+        callbacks->useratom = [](lua_State*, const char* s, size_t l) -> int16_t {
+            return MemberAtoms::find(s, l);
+        };
+}
+
+void MemberAtoms::install(lua_State* L) {
+    setUserAtom(lua_callbacks(L));
+}
+
+void MemberAtoms::retag(lua_State* L) {
+    std::shared_lock lock(mutex);
+
+    stringtable* table = &L->global->strt;
+    for (int i = 0; i < table->size; i++)
+        for (TString* ts = table->hash[i]; ts; ts = ts->next) {
+            if (ts->atom >= 0)
+                continue;
+
+            const int16_t atom = findIn(atom_maps.back(), std::string_view(ts->data, ts->len));
+            if (atom != NO_ATOM)
+                ts->atom = atom;
+        }
+}
+
+void MemberAtoms::freeze() {
+    std::lock_guard lock(mutex);
+    frozen_map.store(&atom_maps.back(), std::memory_order_release);
+}
+
+}; // namespace frostbyte
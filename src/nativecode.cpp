@@ -0,0 +1,39 @@
+#include "nativecode.hpp"
+
+#include "Luau/CodeGen.h"
+
+namespace frostbyte {
+
+NativeCode::Stats NativeCode::stats;
+bool NativeCode::enabled = false;
+bool NativeCode::supported = false;
+
+bool NativeCode::isSupported() {
+    return supported;
+}
+
+void NativeCode::setup(lua_State* L) {
+    supported = Luau::CodeGen::isSupported();
+    if (supported)
+        Luau::CodeGen::create(L);
+}
+
+void NativeCode::compile(lua_State* L, int idx) {
+    if (!supported)
+        return;
+
+    const unsigned int flags = enabled ? 0 : Luau::CodeGen::CodeGen_OnlyNativeModules;
+
+    Luau::CodeGen::CompilationStats compilation_stats;
+    Luau::CodeGen::CompilationResult result = Luau::CodeGen::compile(L, idx, flags, &compilation_stats);
+
+    // NotNativeModule and NothingToCompile just mean the chunk stays interpreted
+    if (result.result == Luau::CodeGen::CodeGenCompilationResult::Success && compilation_stats.functionsCompiled > 0)
+        stats.chunks++;
+    stats.functions_total += compilation_stats.functionsTotal;
+    stats.functions_compiled += compilation_stats.functionsCompiled;
+    stats.failures += result.protoFailures.size();
+    stats.code_bytes += compilation_stats.nativeCodeSizeBytes;
+}
+
+}; // namespace frostbyte
@@ -3,20 +3,23 @@
 #include <algorithm>
 #include <cassert>
 #include <exception>
+#include <limits>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
-#include <thread>
 
 #include "raylib.h"
 
+#include "bytecodecache.hpp"
 #include "common.hpp"
+#include "nativecode.hpp"
+#include "workerpool.hpp"
 
 #include "Luau/Common.h"
 #include "lua.h"
-#include "luacode.h"
 #include "lualib.h"
 #include "lgc.h"
+#include "lstate.h"
 
 namespace frostbyte {
 
@@ -73,6 +76,54 @@ void TaskScheduler::setTargetFps(int target) {
     SetTargetFPS(target);
 }
 
+ClockMode TaskScheduler::clock_mode = ClockMode::Real;
+double TaskScheduler::clock_time = 0.0;
+double TaskScheduler::clock_offset = 0.0;
+double TaskScheduler::fixed_step = 1.0 / 60.0;
+
+ClockMode TaskScheduler::getClockMode() {
+    return clock_mode;
+}
+void TaskScheduler::setClockMode(ClockMode mode) {
+    const double now = getTime();
+    if (mode == ClockMode::Real)
+        clock_offset = now - lua_clock();
+    else
+        clock_time = now;
+
+    clock_mode = mode;
+}
+double TaskScheduler::getTime() {
+    if (clock_mode == ClockMode::Real)
+        return lua_clock() + clock_offset;
+    return clock_time;
+}
+void TaskScheduler::advanceClock() {
+    if (clock_mode == ClockMode::Real)
+        return;
+
+    clock_time += fixed_step;
+
+    if (clock_mode == ClockMode::NextDeadline) {
+        std::unique_lock lock(thread_queue_mutex);
+
+        // skipping to an entry that won't resume anything (an early wake, a kill, a requeue or a cancel) would waste the time
+        while (!timer_heap.empty()) {
+            const TimedThread& entry = timer_heap.top();
+            auto it = queued_threads.find(entry.thread);
+            if (it != queued_threads.end() && it->second == entry.generation) {
+                if (!getTask(entry.thread)->canceled)
+                    break;
+                queued_threads.erase(it);
+            }
+            timer_heap.pop();
+        }
+
+        if (ready_queue.empty() && outstanding_work == 0 && !timer_heap.empty() && timer_heap.top().wake_time > clock_time)
+            clock_time = timer_heap.top().wake_time;
+    }
+}
+
 std::shared_mutex TaskScheduler::gc_mutex;
 bool TaskScheduler::gcShouldRun(lua_State* L) {
     std::lock_guard lock(gc_mutex);
@@ -111,17 +162,153 @@ void TaskScheduler::performGCWork(lua_State* L, std::function<void()> work) {
         resumeGarbageCollection(L);
 }
 
+bool TaskScheduler::idle_gc = true;
+TaskScheduler::GCStats TaskScheduler::gc_stats;
+
+static constexpr int min_gc_step_kb = 8;
+static constexpr int max_gc_step_kb = 1024;
+static constexpr double gc_idle_margin = 0.001; // left unspent so the frame isn't late
+static constexpr size_t gc_min_cycle_debt = 64 * 1024; // allocation that has to build up before a new cycle is started
+
+void TaskScheduler::gcIdleStep(lua_State* L, double deadline) {
+    static size_t last_heap_bytes = 0;
+    static size_t debt = 0; // bytes allocated that idle steps haven't paid for yet
+
+    std::lock_guard lock(gc_mutex);
+
+    const double start = lua_clock();
+    const size_t heap_bytes = static_cast<size_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+
+    gc_stats = GCStats{};
+    gc_stats.allocated = heap_bytes > last_heap_bytes ? heap_bytes - last_heap_bytes : 0;
+    // about eight steps' worth of work per frame's allocation
+    gc_stats.step_kb = std::clamp(static_cast<int>(gc_stats.allocated / 1024 / 8), min_gc_step_kb, max_gc_step_kb);
+
+    // a step of n KB does about n KB of collector work, so the loop stops once the allocation is paid for.
+    // the debt never exceeds the heap, so it can't pile up while the deadline keeps cutting steps short
+    debt = std::min(debt + gc_stats.allocated, heap_bytes);
+    const bool worth_running = gcActuallyPaused(L) ? debt >= gc_min_cycle_debt : debt > 0;
+    if (idle_gc && worth_running && lua_gc(L, LUA_GCISRUNNING, 0))
+        while (debt > 0 && lua_clock() < deadline - gc_idle_margin) {
+            gc_stats.steps++;
+            const size_t step_bytes = static_cast<size_t>(gc_stats.step_kb) * 1024;
+            debt = debt > step_bytes ? debt - step_bytes : 0;
+            if (lua_gc(L, LUA_GCSTEP, gc_stats.step_kb)) {
+                debt = 0; // a finished cycle accounts for everything allocated before it
+                break;
+            }
+        }
+    gc_stats.debt = debt;
+
+    last_heap_bytes = static_cast<size_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+    gc_stats.time = lua_clock() - start;
+}
+
 lua_State* TaskScheduler::mainL = nullptr;
 
-std::vector<lua_State*> TaskScheduler::thread_list;
+void ThreadList::push_back(Task* task) {
+    assert(!task->listed);
+
+    task->prev = tail;
+    task->next = nullptr;
+    if (tail)
+        tail->next = task;
+    else
+        head = task;
+    tail = task;
+
+    task->listed = true;
+    count++;
+}
+bool ThreadList::erase(Task* task) {
+    if (!task->listed)
+        return false;
+
+    if (task->prev)
+        task->prev->next = task->next;
+    else
+        head = task->next;
+    if (task->next)
+        task->next->prev = task->prev;
+    else
+        tail = task->prev;
+
+    task->prev = nullptr;
+    task->next = nullptr;
+    task->listed = false;
+    count--;
+
+    return true;
+}
+void ThreadList::clear() {
+    for (Task* task = head; task;) {
+        Task* next = task->next;
+        task->prev = nullptr;
+        task->next = nullptr;
+        task->listed = false;
+        task = next;
+    }
+
+    head = nullptr;
+    tail = nullptr;
+    count = 0;
+}
+
+ThreadList TaskScheduler::thread_list;
 std::shared_mutex TaskScheduler::thread_list_mutex;
 
-std::vector<lua_State*> TaskScheduler::thread_queue;
+std::unordered_map<lua_State*, uint64_t> TaskScheduler::queued_threads;
+std::deque<std::pair<lua_State*, uint64_t>> TaskScheduler::ready_queue;
+std::priority_queue<TaskScheduler::TimedThread, std::vector<TaskScheduler::TimedThread>, std::greater<TaskScheduler::TimedThread>> TaskScheduler::timer_heap;
+uint64_t TaskScheduler::next_generation = 0;
+double TaskScheduler::frame_budget_share = 0;
+double TaskScheduler::resume_budget = 0.1;
+bool TaskScheduler::kill_over_budget = false;
+TaskScheduler::RunStats TaskScheduler::run_stats;
 std::shared_mutex TaskScheduler::thread_queue_mutex;
 
+std::vector<lua_State*> TaskScheduler::idle_handler_threads;
+
+std::vector<TaskScheduler::CompletedWork> TaskScheduler::completed_work;
+std::mutex TaskScheduler::completed_work_mutex;
+size_t TaskScheduler::outstanding_work = 0;
+
+// the thread the scheduler is resuming and when its resume budget runs out; nested resumes save and restore these
+static lua_State* budget_thread = nullptr;
+static double budget_deadline = 0.0;
+static unsigned budget_check_counter = 0;
+
+static void budgetInterrupt(lua_State* L, int gc) {
+    if (gc >= 0 || !budget_thread)
+        return;
+    // interrupts run on every call and loop iteration, so only look at the clock every so often
+    if (++budget_check_counter % 256 != 0 || lua_clock() < budget_deadline)
+        return;
+
+    if (!TaskScheduler::kill_over_budget) {
+        if (L == budget_thread && lua_isyieldable(L)) {
+            Task* task = getTask(L);
+            task->status = DEFERRING;
+            task->timing = TaskTiming{ .type = TaskTiming::Instant };
+            task->arg_count = 0;
+            TaskScheduler::queueThread(L);
+
+            lua_yield(L, 0);
+            return;
+        }
+
+        // coroutines and code under a metamethod get some leeway to return to a point where the resumed thread can yield
+        if (lua_clock() < budget_deadline + TaskScheduler::resume_budget * (TaskScheduler::unyieldable_budget_factor - 1))
+            return;
+    }
+
+    luaL_error(L, "script exhausted its execution budget of %.0f ms", TaskScheduler::resume_budget * 1000.0);
+}
+
 void TaskScheduler::setup(lua_State *L) {
     mainL = L;
 
+    lua_callbacks(L)->interrupt = budgetInterrupt;
     lua_callbacks(L)->userthread = [] (lua_State* parent, lua_State* thread) {
         if (parent) {
             Task* task = new Task();
@@ -140,11 +327,12 @@ void TaskScheduler::setup(lua_State *L) {
             task->arg_count = 0;
 
             task->capability = ROBLOX_SECURITY;
+            task->thread = thread;
 
             lua_setthreaddata(thread, task);
 
             std::lock_guard lock(TaskScheduler::thread_list_mutex);
-            TaskScheduler::thread_list.push_back(thread);
+            TaskScheduler::thread_list.push_back(task);
         } else {
             killThread(thread);
             Task* task = getTask(thread);
@@ -168,29 +356,37 @@ lua_State* TaskScheduler::newThread(lua_State* L, Feedback feedback, OnKill on_k
     return thread;
 }
 
+// a parked thread that will never resume releases what it's parked on (e.g. a WaitForChild registration)
+static void abandonParking(Task* task) {
+    OnKill on_abandon = std::move(task->on_abandon);
+    task->on_abandon = nullptr;
+    task->on_timeout = nullptr;
+
+    if (on_abandon)
+        on_abandon();
+}
+
 void TaskScheduler::killThreadUnlocked(lua_State* thread) {
     Task* task = getTask(thread);
+    task->killed = true;
     lua_unref(task->parent, task->ref);
 
-    std::shared_lock thread_queue_lock(thread_queue_mutex);
+    std::unique_lock thread_queue_lock(thread_queue_mutex);
+    queued_threads.erase(thread);
+    thread_queue_lock.unlock();
 
-    auto thread_queue_position = std::find(thread_queue.begin(), thread_queue.end(), thread);
-    if (thread_queue_position != thread_queue.end())
-        thread_queue.erase(thread_queue_position);
+    abandonParking(task);
 
     // TODO: handle exception?
     if (task->on_kill)
         task->on_kill();
 }
 void TaskScheduler::killThread(lua_State* thread) {
-    std::shared_lock thread_list_lock(thread_list_mutex);
-
-    auto thread_list_position = std::find(thread_list.begin(), thread_list.end(), thread);
-    if (thread_list_position == thread_list.end())
+    {
+    std::lock_guard thread_list_lock(thread_list_mutex);
+    if (!thread_list.erase(getTask(thread)))
         return;
-    thread_list.erase(thread_list_position);
-
-    thread_list_lock.unlock();
+    }
 
     killThreadUnlocked(thread);
 }
@@ -200,8 +396,16 @@ bool resumeThreadRaw(lua_State* thread) {
 
     task->status = RUNNING;
 
+    lua_State* const outer_budget_thread = budget_thread;
+    const double outer_budget_deadline = budget_deadline;
+    budget_thread = TaskScheduler::resume_budget > 0 ? thread : nullptr;
+    budget_deadline = lua_clock() + TaskScheduler::resume_budget;
+
     int status = lua_resume(thread, task->parent, task->arg_count);
 
+    budget_thread = outer_budget_thread;
+    budget_deadline = outer_budget_deadline;
+
     switch (status) {
         case LUA_OK:
             return false;
@@ -245,7 +449,7 @@ void tryResumeThreadRaw(lua_State* thread) {
         const bool yield = resumeThreadRaw(thread);
         if (yield)
             return;
-        TaskScheduler::killThread(thread);
+        TaskScheduler::finishThread(thread);
     } catch (std::exception& e) {
         // TODO: either move killThread after and wrap feedback in another try catch or don't worry about the order (ask if feedback will care if thread was killed or not)
         TaskScheduler::killThread(thread);
@@ -253,6 +457,65 @@ void tryResumeThreadRaw(lua_State* thread) {
     }
 }
 
+void TaskScheduler::finishThread(lua_State* thread) {
+    Task* task = getTask(thread);
+    if (!task->recyclable || task->canceled || idle_handler_threads.size() >= max_idle_handler_threads) {
+        killThread(thread);
+        return;
+    }
+
+    {
+    std::lock_guard thread_list_lock(thread_list_mutex);
+    if (!thread_list.erase(task))
+        return; // already killed
+    }
+
+    lua_resetthread(thread);
+    task->status = IDLE;
+    task->timing = TaskTiming{};
+    task->arg_count = 0;
+
+    // the next handler is unrelated, so it mustn't inherit an identity this one set, or its name in the thread list
+    task->capability = ROBLOX_SECURITY;
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%p", static_cast<void*>(thread));
+    task->identifier = std::string(buffer);
+    task->view.open = false;
+
+    idle_handler_threads.push_back(thread);
+}
+
+void TaskScheduler::spawnHandler(lua_State* L, int arg_count) {
+    Task* parent_task = getTask(L);
+    assert(parent_task);
+
+    lua_State* thread;
+    if (idle_handler_threads.empty()) {
+        thread = newThread(L, parent_task->feedback);
+        lua_pop(L, 1);
+        getTask(thread)->recyclable = true;
+    } else {
+        thread = idle_handler_threads.back();
+        idle_handler_threads.pop_back();
+
+        Task* task = getTask(thread);
+        task->parent = L;
+        task->console = parent_task->console;
+        task->feedback = parent_task->feedback;
+
+        // the stephook toggles single-step mode on the main thread and thread_list, which this thread was missing from while parked
+        lua_singlestep(thread, L->global->mainthread->singlestep);
+
+        std::lock_guard thread_list_lock(thread_list_mutex);
+        thread_list.push_back(task);
+    }
+
+    lua_xmove(L, thread, arg_count + 1);
+    getTask(thread)->arg_count = arg_count;
+
+    tryResumeThreadRaw(thread);
+}
+
 void TaskScheduler::startFunctionOnNewThread(lua_State* L, Feedback feedback, Console* console) {
     luaL_checktype(L, lua_gettop(L), LUA_TFUNCTION);
 
@@ -268,16 +531,12 @@ void TaskScheduler::startFunctionOnNewThread(lua_State* L, Feedback feedback, Co
 }
 
 void TaskScheduler::startCodeOnNewThread(lua_State* L, const char* chunk_name, const char* code, size_t code_size, Feedback feedback, OnKill on_kill, Console* console) {
-    size_t bytecode_size = 0;
-    char* bytecode = luau_compile(code, code_size, NULL, &bytecode_size);
-    if (!bytecode)
-        throw std::runtime_error("failed to allocate memory for script bytecode");
+    const std::string bytecode = BytecodeCache::compile(std::string(code, code_size), chunk_name);
 
     lua_State* thread = newThread(L, feedback, on_kill);
     lua_pop(L, 1);
 
-    int r = luau_load(thread, chunk_name, bytecode, bytecode_size, 0);
-    free(bytecode);
+    int r = luau_load(thread, chunk_name, bytecode.data(), bytecode.size(), 0);
 
     if (r) {
         std::string msg = std::string("failed to load chunk: ")
@@ -289,6 +548,8 @@ void TaskScheduler::startCodeOnNewThread(lua_State* L, const char* chunk_name, c
         throw std::runtime_error(msg);
     }
 
+    NativeCode::compile(thread, -1);
+
     Task* task = getTask(thread);
     task->arg_count = 0;
     if (console) task->console = console;
@@ -304,95 +565,203 @@ int TaskScheduler::yieldThread(lua_State* thread) {
     return lua_yield(thread, 0);
 }
 
-int TaskScheduler::yieldForWork(lua_State* thread, Workload work) {
-    Task* task = getTask(thread);
-    assert(task);
+int TaskScheduler::yieldForWork(lua_State* thread, std::function<Workload()> work) {
+    assert(getTask(thread));
 
-    int r = yieldThread(thread);
+    lua_pushthread(thread);
+    const int ref = lua_ref(thread, -1);
+    lua_pop(thread, 1);
 
-    std::thread t([thread, task, work]() {
-        int arg_count = 0;
+    outstanding_work++;
+    WorkerPool::submit([thread, ref, work] {
+        CompletedWork completed{ .thread = thread, .ref = ref };
         try {
-            arg_count = work(thread);
-        } catch(std::exception& e) {
-            killThread(thread);
-            task->feedback(e.what());
-            return;
+            completed.push_results = work();
+        } catch (std::exception& e) {
+            completed.error = e.what();
         }
 
-        queueForResume(thread, arg_count);
+        std::lock_guard lock(completed_work_mutex);
+        completed_work.push_back(std::move(completed));
     });
 
-    t.detach();
+    return yieldThread(thread);
+}
+void TaskScheduler::resumeCompletedWork() {
+    static std::vector<CompletedWork> completed;
+    {
+    std::lock_guard lock(completed_work_mutex);
+    std::swap(completed, completed_work);
+    }
+
+    outstanding_work -= completed.size();
 
-    return r;
+    for (auto& work : completed) {
+        Task* task = getTask(work.thread);
+
+        if (!task->canceled && !task->killed) {
+            try {
+                if (work.error)
+                    throw std::runtime_error(*work.error);
+                queueForResume(work.thread, work.push_results(work.thread));
+            } catch (std::exception& e) {
+                killThread(work.thread);
+                task->feedback(e.what());
+            }
+        }
+
+        lua_unref(work.thread, work.ref);
+    }
+    completed.clear();
 }
 
-void TaskScheduler::resumeThread(lua_State* thread) {
+int TaskScheduler::yieldWithTimeout(lua_State* thread, double timeout, Workload on_timeout, OnKill on_abandon) {
+    Task* task = getTask(thread);
+    assert(task);
+
+    task->status = WAITING;
+    task->timing = TaskTiming{
+        .type = TaskTiming::Timeout,
+        .start_time = getTime(),
+        .count = timeout
+    };
+    task->arg_count = 0;
+    task->on_timeout = on_timeout;
+    task->on_abandon = on_abandon;
+    queueThread(thread);
+
+    return lua_yield(thread, 0);
+}
+void TaskScheduler::wakeThread(lua_State* thread, int arg_count) {
     std::unique_lock thread_queue_lock(thread_queue_mutex);
-    thread_queue.erase(std::find(thread_queue.begin(), thread_queue.end(), thread));
-    thread_queue_lock.unlock();
+    if (queued_threads.find(thread) == queued_threads.end())
+        return;
 
     Task* task = getTask(thread);
+    assert(task);
 
-    if (task->canceled)
+    task->arg_count = arg_count;
+    task->timing = TaskTiming{ .type = TaskTiming::Instant };
+    task->on_timeout = nullptr;
+    task->on_abandon = nullptr;
+
+    // requeueing supersedes the timer entry
+    queueThreadUnlocked(thread);
+}
+
+void TaskScheduler::resumeThread(lua_State* thread) {
+    Task* task = getTask(thread);
+
+    if (task->canceled) {
+        abandonParking(task);
         return;
+    }
 
     if (task->timing.type == TaskTiming::Wait) {
         // NOTE: count becomes elapsed, so return it
         lua_pushnumber(thread, task->timing.count);
         task->arg_count = 1;
+    } else if (task->timing.type == TaskTiming::Timeout && task->on_timeout) {
+        task->arg_count = task->on_timeout(thread);
+        task->on_timeout = nullptr;
+        task->on_abandon = nullptr;
     }
 
     tryResumeThreadRaw(thread);
 }
 
+bool TaskScheduler::takeQueuedUnlocked(lua_State* thread, uint64_t generation) {
+    auto it = queued_threads.find(thread);
+    if (it == queued_threads.end() || it->second != generation)
+        return false;
+
+    queued_threads.erase(it);
+    return true;
+}
+
 void TaskScheduler::run() {
-    std::shared_lock task_queue_lock(thread_queue_mutex);
+    resumeCompletedWork();
+
+    const double now = getTime();
+    // the budget is real time even when the clock is simulated
+    double deadline = std::numeric_limits<double>::infinity();
+    {
+        std::shared_lock lock(target_fps_mutex);
+        if (frame_budget_share > 0 && target_fps > 0)
+            deadline = lua_clock() + frame_budget_share / target_fps;
+    }
 
-    static std::vector<lua_State*> filtered_threads;
-    filtered_threads.clear();
+    std::unique_lock thread_queue_lock(thread_queue_mutex);
 
-    for (size_t i = 0; i < thread_queue.size(); i++) {
-        lua_State* thread = thread_queue[i];
-        Task* task = getTask(thread);
-        assert(task->status != RUNNING);
+    // only what was ready before this run; threads requeued while resuming wait for the next one.
+    // ready threads go first, then expired timers by wake time; whatever is left when the budget runs out stays queued in that order
+    size_t ready_count = ready_queue.size();
+    run_stats.resumed = 0;
 
-        bool passes = false;
-        TaskTiming& timing = task->timing;
+    while (true) {
+        lua_State* thread = nullptr;
 
-        switch (timing.type) {
-            case TaskTiming::Instant:
-                passes = true;
-                break;
-            case TaskTiming::Wait: {
-                const double elapsed = lua_clock() - timing.start_time;
-                passes = elapsed >= timing.count;
-                if (passes) timing.count = elapsed;
-                break;
-            }
-            case TaskTiming::Delay: {
-                passes = (lua_clock() - timing.start_time) >= timing.count;
-                break;
+        if (ready_count > 0) {
+            auto [ready_thread, generation] = ready_queue.front();
+            ready_queue.pop_front();
+            ready_count--;
+
+            if (takeQueuedUnlocked(ready_thread, generation))
+                thread = ready_thread;
+        } else if (!timer_heap.empty() && timer_heap.top().wake_time <= now) {
+            const TimedThread entry = timer_heap.top();
+            timer_heap.pop();
+
+            if (takeQueuedUnlocked(entry.thread, entry.generation)) {
+                TaskTiming& timing = getTask(entry.thread)->timing;
+                if (timing.type == TaskTiming::Wait)
+                    timing.count = now - timing.start_time;
+
+                thread = entry.thread;
             }
-        }
+        } else
+            break;
+
+        if (!thread)
+            continue;
 
-        if (passes)
-            filtered_threads.push_back(thread);
+        thread_queue_lock.unlock();
+        resumeThread(thread);
+        run_stats.resumed++;
+        thread_queue_lock.lock();
+
+        if (lua_clock() >= deadline)
+            break;
     }
-    task_queue_lock.unlock();
 
-    for (size_t i = 0; i < filtered_threads.size(); i++)
-        resumeThread(filtered_threads[i]);
+    run_stats.carried = ready_count;
+    if (ready_count > 0 || (!timer_heap.empty() && timer_heap.top().wake_time <= now))
+        run_stats.over_budget_runs++;
+}
+
+bool TaskScheduler::hasPendingWork() {
+    if (outstanding_work > 0)
+        return true;
+
+    std::shared_lock lock(thread_queue_mutex);
+    return !queued_threads.empty();
 }
 
 void TaskScheduler::cleanup() {
     mainL = nullptr;
 
+    WorkerPool::stop();
+    completed_work.clear();
+    outstanding_work = 0;
+
+    for (lua_State* thread : idle_handler_threads)
+        killThreadUnlocked(thread);
+    idle_handler_threads.clear();
+
     std::lock_guard lock(thread_list_mutex);
 
-    for (size_t i = 0; i < thread_list.size(); i++)
-        killThreadUnlocked(thread_list[i]);
+    for (lua_State* thread : thread_list)
+        killThreadUnlocked(thread);
 
     thread_list.clear();
 }
@@ -458,9 +827,22 @@ std::optional<PreSpawnResult> preTaskSpawn(lua_State* L, const char* func_name,
     return PreSpawnResult{ .thread = thread, .arg_count = arg_count };
 }
 
+void TaskScheduler::queueThreadUnlocked(lua_State* thread) {
+    Task* task = getTask(thread);
+    assert(task);
+
+    const uint64_t generation = next_generation++;
+    queued_threads[thread] = generation;
+
+    const TaskTiming& timing = task->timing;
+    if (timing.type == TaskTiming::Instant)
+        ready_queue.emplace_back(thread, generation);
+    else
+        timer_heap.push({ .wake_time = timing.start_time + timing.count, .generation = generation, .thread = thread });
+}
 void TaskScheduler::queueThread(lua_State* thread) {
-    std::shared_lock lock(thread_queue_mutex);
-    thread_queue.push_back(thread);
+    std::lock_guard lock(thread_queue_mutex);
+    queueThreadUnlocked(thread);
 }
 
 void TaskScheduler::queueForResume(lua_State* thread, int arg_count) {
@@ -481,7 +863,7 @@ int fr_task_wait(lua_State* L) {
     task->status = WAITING;
     task->timing = TaskTiming{
         .type = TaskTiming::Wait,
-        .start_time = lua_clock(),
+        .start_time = TaskScheduler::getTime(),
         .count = seconds
     };
     task->arg_count = 0;
@@ -537,7 +919,7 @@ int fr_task_delay(lua_State* L) {
     task->status = DELAYING;
     task->timing = TaskTiming{
         .type = TaskTiming::Delay,
-        .start_time = lua_clock(),
+        .start_time = TaskScheduler::getTime(),
         .count = seconds
     };
 
@@ -554,6 +936,7 @@ int fr_task_cancel(lua_State* L) {
     assert(task);
 
     task->canceled = true;
+    abandonParking(task);
     return 0;
 }
 
@@ -26,10 +26,64 @@ namespace frostbyte {
             "assert(elapsed >= count, 'not enough time was elapsed')\n"
             "print('waited for ' .. elapsed .. ' seconds')"
         },
+        { .name = "resume budget yields runaway loops", .value = "local deferred_ran = false \
+            task.defer(function() deferred_ran = true end) \
+            local start = os.clock() \
+            while not deferred_ran and os.clock() - start < 2 do end \
+            assert(deferred_ran, 'a thread that never yields kept the scheduler from running') \
+        "},
+        { .name = "loadstring cache", .value = "local a = loadstring('return ...') \
+            local b = loadstring('return ...') \
+            assert(a ~= b and a(1) == 1 and b(2) == 2, 'cached bytecode should still load into separate functions') \
+            local f, e1 = loadstring('return +') \
+            local g, e2 = loadstring('return +') \
+            assert(f == nil and g == nil and e1 == e2, 'a cached compile error should report the same way') \
+        "},
+        { .name = "compile options", .value = "local old = getcompileoptions() \
+            setcompileoptions({ optimizationLevel = 2 }) \
+            assert(getcompileoptions().optimizationLevel == 2 and getcompileoptions().debugLevel == old.debugLevel) \
+            local f = loadstring('local function add(a, b) return a + b end return add(1, 2)') \
+            local success = pcall(setcompileoptions, { optimizationLevel = 3 }) \
+            setcompileoptions(old) \
+            assert(f() == 3, 'inlined code should behave the same') \
+            assert(not success, 'optimizationLevel should be range checked') \
+        "},
 
         { .name = "instance cache", .value = "assert(game.Workspace == workspace) "},
         { .name = "instance method cache", .value = "assert(game.Destroy == workspace.Destroy)" },
         { .name = "instance method route", .value = "assert(game.children == game.GetChildren)" },
+        { .name = "instance find first child", .value = "local folder = Instance.new('Folder') \
+            local a = Instance.new('Part', folder) \
+            local b = Instance.new('Part', folder) \
+            b.Name = 'Target' \
+            a.Name = 'Target' \
+            assert(folder:FindFirstChild('Target') == a) \
+            assert(folder.Target == a) \
+            a.Parent = nil \
+            assert(folder:FindFirstChild('Target') == b) \
+            b.Name = 'Other' \
+            assert(folder:FindFirstChild('Target') == nil and folder.Other == b) \
+        "},
+        { .name = "instance wait for child", .value = "local folder = Instance.new('Folder') \
+            local part = Instance.new('Part') \
+            task.delay(0.05, function() part.Parent = folder end) \
+            assert(folder:WaitForChild('Part', 1) == part) \
+            task.delay(0.05, function() part.Name = 'Renamed' end) \
+            assert(folder:WaitForChild('Renamed', 1) == part) \
+        "},
+        { .name = "canceled wait for child", .value = "local folder = Instance.new('Folder') \
+            local waiter = task.spawn(function() folder:WaitForChild('Missing', 60) end) \
+            local function refs() local count = 0 for _, v in getreg() do if v == waiter then count += 1 end end return count end \
+            local before = refs() \
+            task.cancel(waiter) \
+            assert(refs() == before - 1, 'canceling should drop the WaitForChild ref') \
+            local child = Instance.new('Folder') child.Name = 'Missing' child.Parent = folder \
+        "},
+        { .name = "instance isa", .value = "local button = Instance.new('TextButton') \
+            assert(button:IsA('TextButton') and button:IsA('GuiButton') and button:IsA('Instance')) \
+            assert(not button:IsA('Frame') and not button:IsA('NotAClass')) \
+        "},
+        { .name = "instance namecall route", .value = "assert(#game:children() == #game:GetChildren())" },
 
         { .name = "BindableEvent", .value = "local target = {} \
             local upvalue \
@@ -49,6 +103,92 @@ namespace frostbyte {
             assert(not con.Connected, 'Connected should be false after disconnection') \
         "},
 
+        { .name = "RBXScriptSignal disconnect churn", .value = "local event = Instance.new('BindableEvent') \
+            local count = 0 \
+            for i = 1, 100 do \
+                event.Event:Connect(function() count += 1 end):Disconnect() \
+            end \
+            local con = event.Event:Connect(function() count += 1 end) \
+            event.Event:Connect(function() con:Disconnect() end) \
+            event:Fire() \
+            event:Fire() \
+            task.wait() \
+            assert(count == 1, 'expected 1 call, got ' .. count) \
+        "},
+
+        { .name = "thread list removal", .value = "local first = coroutine.create(function() end) \
+            local middle = setmetatable({ coroutine.create(function() end) }, { __mode = 'v' }) \
+            local last = coroutine.create(function() end) \
+            gcfull() \
+            assert(middle[1] == nil, 'the middle thread should have been collected') \
+            local seen = 0 \
+            for _, thread in getallthreads() do \
+                if thread == first or thread == last then seen += 1 end \
+            end \
+            assert(seen == 2, 'threads on either side of a removed one should stay listed') \
+        "},
+        { .name = "drawing lookup slots", .value = "local objects = {} \
+            for i = 1, 6 do objects[i] = Drawing.new('Square') end \
+            objects[2]:Remove() \
+            objects[4]:Remove() \
+            local live = { objects[1], objects[3], objects[5], objects[6] } \
+            for i = 1, 3 do table.insert(live, Drawing.new('Square')) end \
+            local seen = {} \
+            for _, object in Drawing.GetObjects() do seen[object] = (seen[object] or 0) + 1 end \
+            for _, object in live do \
+                assert(seen[object] == 1, 'a new object should not take the slot of a live one') \
+                object:Remove() \
+            end \
+        "},
+        { .name = "connection lookup slots", .value = "local lookup = getreg().rbxscriptconnectionmethodlookup \
+            local function slots() local count = 0 for _ in lookup do count += 1 end return count end \
+            local before = slots() \
+            local event = Instance.new('BindableEvent') \
+            for i = 1, 100 do \
+                event.Event:Connect(function() end):Disconnect() \
+            end \
+            assert(slots() == before, 'disconnecting should free the slot, ' .. slots() - before .. ' left over') \
+            local handler = function() end \
+            local a = event.Event:Connect(handler) \
+            local b = event.Event:Connect(handler) \
+            assert(slots() == before + 1, 'connections to the same function should share a slot') \
+            a:Disconnect() \
+            assert(slots() == before + 1, 'the slot should stay while another connection uses it') \
+            b:Disconnect() \
+            assert(slots() == before, 'the slot should be freed once its last connection is gone') \
+        "},
+        { .name = "recycled handler identity", .value = "local event = Instance.new('BindableEvent') \
+            local identities = {} \
+            event.Event:Connect(function() \
+                table.insert(identities, getthreadidentity()) \
+                setthreadidentity(3) \
+            end) \
+            event:Fire() \
+            event:Fire() \
+            assert(identities[2] == identities[1], 'a reused handler thread kept identity ' .. tostring(identities[2])) \
+        "},
+        { .name = "recycled handler yields", .value = "local event = Instance.new('BindableEvent') \
+            local threads = {} \
+            local yielding, kept \
+            event.Event:Connect(function(yields) \
+                if yields then \
+                    yielding = coroutine.running() \
+                    task.wait(0.05) \
+                    kept = coroutine.running() == yielding \
+                else \
+                    table.insert(threads, coroutine.running()) \
+                end \
+            end) \
+            event:Fire(false) \
+            event:Fire(false) \
+            assert(threads[1] == threads[2], 'a handler that returned should hand its thread to the next one') \
+            event:Fire(true) \
+            event:Fire(false) \
+            assert(threads[3] ~= yielding, 'a handler that yielded should keep its thread') \
+            task.wait(0.1) \
+            assert(kept, 'the yielding handler should resume on its own thread') \
+        "},
+
         { .name = "instance changed", .value = "local count = 0\n"
             "local inst = Instance.new(\"Part\")\n"
             "inst.Changed:Connect(function()\n"
@@ -69,6 +209,61 @@ namespace frostbyte {
             "task.wait();"
             "assert(count == 1)\n"
         },
+        { .name = "deferred changed", .value = "local previous = getsignalbehavior() \
+            setsignalbehavior('Deferred') \
+            local part = Instance.new('Part') \
+            local seen = {} \
+            part:GetPropertyChangedSignal('Name'):Connect(function() table.insert(seen, part.Name) end) \
+            part.Name = 'A' \
+            part.Name = 'B' \
+            part.Name = 'C' \
+            assert(#seen == 0, 'deferred handlers should not run inside the write') \
+            local chain = Instance.new('Part') \
+            local fires = 0 \
+            chain:GetPropertyChangedSignal('Name'):Connect(function() \
+                fires += 1 \
+                if fires < 25 then chain.Name = 'Link' .. fires end \
+            end) \
+            chain.Name = 'Start' \
+            local doomed = Instance.new('Part') \
+            local doomed_fires = 0 \
+            doomed.Changed:Connect(function() doomed_fires += 1 end) \
+            doomed.Name = 'Destroyed' \
+            doomed:Destroy() \
+            local collected = Instance.new('Part') \
+            collected.Changed:Connect(function() doomed_fires += 1 end) \
+            collected.Name = 'Collected' \
+            collected = nil \
+            gcfull() \
+            task.wait() \
+            assert(#seen == 1 and seen[1] == 'C', 'writes in one frame should fire once with the last value, fired ' .. #seen .. ' times') \
+            assert(fires > 0 and fires < 25 and fires % 10 == 0, 'each flush should stop after 10 rounds, got ' .. fires) \
+            for i = 1, 5 do task.wait() end \
+            assert(fires == 25, 'changes past the round limit should carry into the next flush, got ' .. fires) \
+            assert(doomed_fires == 0, 'instances gone before the flush should be skipped') \
+            setsignalbehavior(previous) \
+        "},
+        { .name = "instance property changed signal", .value = "local inst = Instance.new('Part') \
+            inst.Name = 'Before' \
+            local signal = inst:GetPropertyChangedSignal('Name') \
+            assert(signal == inst:GetPropertyChangedSignal('Name')) \
+            local count = 0 \
+            signal:Connect(function() count += 1 end) \
+            inst.Name = 'After' \
+            task.wait() \
+            assert(count == 1) \
+        "},
+
+        { .name = "instance clone properties", .value = "local frame = Instance.new('Frame') \
+            frame.Name = 'Original' \
+            frame.Size = UDim2.new(1, 2, 3, 4) \
+            frame.Parent = workspace \
+            local clone = frame:Clone() \
+            assert(clone.Name == 'Original') \
+            assert(clone.Size.X.Offset == 2 and clone.Size.Y.Scale == 3) \
+            assert(clone.Parent == nil) \
+            frame:Destroy() \
+        "},
 
         { .name = "Enum equality", .value = "assert(Enum.KeyCode == Enum.KeyCode) "},
         { .name = "EnumItem equality", .value = "assert(Enum.KeyCode.A == Enum.KeyCode.A)" },
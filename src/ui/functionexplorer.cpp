@@ -32,9 +32,11 @@ void UI_FunctionExplorer_setSelectedFunction(lua_State* L, Closure* cl) {
     lua_rawsetfield(L, LUA_REGISTRYINDEX, SELECTED_FUNCTION_KEY);
 }
 
+static rbxClass* functionexplorer_class; // set in UI_FunctionExplorer_init
+
 namespace UI_FunctionExplorer_methods {
     static int selectFunction(lua_State* L) {
-        std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1, "FunctionExplorer");
+        std::shared_ptr<rbxInstance> instance = lua_checkinstance(L, 1, functionexplorer_class);
         luaL_checktype(L, 2, LUA_TFUNCTION);
         luaL_argcheck(L, lua_gettop(L) == 2, 3, "too many arguments");
 
@@ -46,6 +48,7 @@ namespace UI_FunctionExplorer_methods {
 
 void UI_FunctionExplorer_init(lua_State* L, std::shared_ptr<rbxInstance> datamodel) {
     auto FunctionExplorer = std::make_shared<rbxClass>();
+    functionexplorer_class = FunctionExplorer.get();
     FunctionExplorer->name.assign("FunctionExplorer");
     FunctionExplorer->tags |= rbxClass::NotCreatable;
     FunctionExplorer->superclass = rbxClass::class_map["Instance"];
@@ -10,6 +10,7 @@
 namespace frostbyte {
 
 std::shared_ptr<rbxInstance> game;
+static rbxClass* inputobject_class;
 
 std::weak_ptr<rbxInstance> selected_instance;
 
@@ -25,6 +26,7 @@ std::queue<ContextQueueItem> context_queue;
 
 void UI_InstanceExplorer_init(std::shared_ptr<rbxInstance> datamodel) {
     game = datamodel;
+    inputobject_class = rbxClass::class_map.at("InputObject").get();
 }
 
 // options
@@ -81,7 +83,7 @@ void renderNode(lua_State* L, std::shared_ptr<rbxInstance> instance, std::vector
     }
 }
 void renderInstance(lua_State* L, std::shared_ptr<rbxInstance>& instance) {
-    if (!show_input_objects && instance->isA("InputObject"))
+    if (!show_input_objects && instance->isA(inputobject_class))
         return;
 
     std::shared_lock instance_children_lock(instance->children_mutex);
@@ -236,36 +238,44 @@ void UI_InstanceExplorer_render(lua_State *L) {
 
     ImGui::BeginChild("Properties", ImVec2{0, 0}, ImGuiChildFlags_None);
 
-    const auto& rbxinstance_parent_property = rbxClass::class_map["Instance"]->properties["Parent"];
-
     if (auto selected = selected_instance.lock()) {
         auto selected_name = getInstanceValue<std::string>(selected, PROP_INSTANCE_NAME);
         ImGui::Text("%.*s", static_cast<int>(selected_name.size()), selected_name.c_str());
 
+        std::optional<std::string> renamed_from;
+
         ImGui::SeparatorText("Properties");
         if (ImGui::BeginTable("Properties##table", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
             std::lock_guard values_lock(selected->values_mutex);
 
-            for (auto& value_pair : selected->values) {
-                auto& property = value_pair.second.property;
-                if (property->tags & rbxProperty::Hidden || property->tags & rbxProperty::Deprecated
-                    || property->tags & rbxProperty::WriteOnly || property->tags & rbxProperty::NotScriptable
+            auto& slots = selected->_class->slots;
+            for (size_t slot = 0; slot < slots.size(); slot++) {
+                auto& property = slots[slot];
+                const uint8_t tags = selected->getPropertyTags(slot);
+                if (tags & rbxProperty::Hidden || tags & rbxProperty::Deprecated
+                    || tags & rbxProperty::WriteOnly || tags & rbxProperty::NotScriptable
                 ) { continue; }
 
                 ImGui::TableNextRow();
 
                 ImGui::TableNextColumn();
-                ImGui::Text("%.*s", static_cast<int>(value_pair.first.size()), value_pair.first.c_str());
+                ImGui::Text("%.*s", static_cast<int>(property->name.size()), property->name.c_str());
                 ImGui::TableNextColumn();
 
-                const bool read_only = property->tags & rbxProperty::ReadOnly;
-                const bool parent_locked = property == rbxinstance_parent_property && selected->parent_locked;
+                const bool read_only = tags & rbxProperty::ReadOnly;
+                const bool parent_locked = slot == rbxInstance::parent_slot && selected->parent_locked;
 
                 const bool disabled = read_only || parent_locked;
                 if (disabled)
                     ImGui::BeginDisabled();
 
-                renderPropertyValue(property.get(), value_pair.second.value);
+                if (slot == rbxInstance::name_slot) {
+                    std::string old_name = std::get<std::string>(selected->values[slot]);
+                    renderPropertyValue(property.get(), selected->values[slot]);
+                    if (std::get<std::string>(selected->values[slot]) != old_name)
+                        renamed_from = std::move(old_name);
+                } else
+                    renderPropertyValue(property.get(), selected->values[slot]);
 
                 if (read_only)
                     ImGui::SetItemTooltip("read-only");
@@ -279,6 +289,10 @@ void UI_InstanceExplorer_render(lua_State *L) {
             ImGui::EndTable();
         }
 
+        if (renamed_from)
+            if (auto parent = getInstanceValue<std::shared_ptr<rbxInstance>>(selected, rbxInstance::parent_slot))
+                renameInstanceChild(parent, selected, *renamed_from, getInstanceValue<std::string>(selected, rbxInstance::name_slot));
+
         ImGui::SeparatorText("Attributes");
         ImGui::Text("WIP");
     }
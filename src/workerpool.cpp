@@ -0,0 +1,95 @@
+#include "workerpool.hpp"
+
+#include <algorithm>
+
+namespace frostbyte {
+
+std::vector<std::unique_ptr<WorkerPool::Worker>> WorkerPool::workers;
+std::atomic<size_t> WorkerPool::next_worker = 0;
+
+std::mutex WorkerPool::sleep_mutex;
+std::condition_variable WorkerPool::wake;
+size_t WorkerPool::pending = 0;
+bool WorkerPool::stopping = false;
+
+void WorkerPool::start() {
+    const size_t count = std::max(1u, std::thread::hardware_concurrency());
+
+    workers.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        workers.push_back(std::make_unique<Worker>());
+    for (size_t i = 0; i < count; i++)
+        workers[i]->thread = std::thread(run, i);
+}
+
+void WorkerPool::submit(Job job) {
+    if (workers.empty())
+        start();
+
+    Worker& worker = *workers[next_worker++ % workers.size()];
+    {
+    std::lock_guard lock(worker.mutex);
+    worker.jobs.push_back(std::move(job));
+    }
+
+    {
+    std::lock_guard lock(sleep_mutex);
+    pending++;
+    }
+    wake.notify_one();
+}
+
+bool WorkerPool::take(size_t index, Job& job) {
+    for (size_t i = 0; i < workers.size(); i++) {
+        Worker& worker = *workers[(index + i) % workers.size()];
+        std::lock_guard lock(worker.mutex);
+        if (worker.jobs.empty())
+            continue;
+
+        // own queue from the front, others from the back
+        if (i == 0) {
+            job = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+        } else {
+            job = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+void WorkerPool::run(size_t index) {
+    while (true) {
+        {
+        std::unique_lock lock(sleep_mutex);
+        wake.wait(lock, [] { return stopping || pending > 0; });
+        if (stopping)
+            return;
+        // jobs are queued before pending is raised, so claiming one guarantees take finds a job
+        pending--;
+        }
+
+        Job job;
+        if (take(index, job))
+            job();
+    }
+}
+
+void WorkerPool::stop() {
+    {
+    std::lock_guard lock(sleep_mutex);
+    stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+        worker->thread.join();
+    workers.clear();
+
+    std::lock_guard lock(sleep_mutex);
+    stopping = false;
+    pending = 0;
+}
+
+}; // namespace frostbyte